@@ -20,7 +20,7 @@ command-line option. Also note that the first variable in the enumeration
 must be left unchanged.
 -----------------------------------------------------------------------------*/
 enum commands {
-    FIRST, BCD, BIN, CO1, CO2, DEC, FLT, HEX, MES, OCT, ROM
+    FIRST, BCD, BIN, CO1, CO2, DEC, FLT, HEX, MES, OCT, ROM, B32, B58, B64, ALF
 };
 
 /* The following string arrays specify all the names that can be entered from
@@ -48,15 +48,139 @@ const struct codify code[] = {
         {.id = HEX, .signf = 1, .signt = 1, .decimal = 1, .name = {"Hexadecimal Base", "hex", "HEX", "hexadecimal","HEXADECIMAL", "16"}},
         {.id = MES, .signf = 0, .signt = 1, .decimal = 0, .name = {"Signed Magnitude Representation", "ms", "MS", "mes","MES"}},
         {.id = OCT, .signf = 1, .signt = 1, .decimal = 1, .name = {"Octal Base", "oct", "OCT", "octal", "OCTAL", "8"}},
-        {.id = ROM, .signf = 0, .signt = 0, .decimal = 0, .name = {"Roman Numerals", "rom", "ROM", "roman", "ROMAN"}}
+        {.id = ROM, .signf = 0, .signt = 0, .decimal = 0, .name = {"Roman Numerals", "rom", "ROM", "roman", "ROMAN"}},
+        {.id = B32, .signf = 0, .signt = 0, .decimal = 0, .name = {"RFC 4648 Base32", "b32", "B32"}},
+        {.id = B58, .signf = 0, .signt = 0, .decimal = 0, .name = {"Base58", "b58", "B58"}},
+        {.id = B64, .signf = 0, .signt = 0, .decimal = 0, .name = {"RFC 4648 Base64", "b64", "B64"}},
+        {.id = ALF, .signf = 0, .signt = 0, .decimal = 0, .name = {"Custom Alphabet", "alpha", "ALPHA", "alphabet", "ALPHABET"}}
+
+};
+
+/* The following enumeration lists the errors of a conversion. The values are
+the codes written in JSON output (option -j), which are read by other programs:
+a new error must be added at the end, so that the codes already in use do not
+change. The string array gives the message of each error.
+-----------------------------------------------------------------------------*/
+enum errors {
+    E_NONE, E_CODIFY, E_BASE, E_INTEGER, E_POSITIVE, E_NATURAL, E_LARGE, E_BCD, E_UNARY, E_BIT, E_MEMORY, E_RING, E_SPEC, E_SATURATE
+};
+
+const char *const error_text[] = {
+
+        [E_NONE] = "",
+        [E_CODIFY] = "The codify is not correct.",
+        [E_BASE] = "Inserted number is not in base %u.",
+        [E_INTEGER] = "%s accepts only integer.",
+        [E_POSITIVE] = "%s accepts only positive numbers.",
+        [E_NATURAL] = "Unary numeral system admits only natural numbers.",
+        [E_LARGE] = "The number is too large for this codify.",
+        [E_BCD] = "BCD codify is not correct.",
+        [E_UNARY] = "Numbers above %d are written in unary by stream mode (-S).",
+        [E_BIT] = "Too few bit. It requires almost %u bit.",
+        [E_MEMORY] = "Memory allocation error.",
+        [E_RING] = "A number and its results must fit in %d characters.",
+        [E_SPEC] = "'%s' is not a valid codify.",
+        [E_SATURATE] = "The number is out of the range of %sQ%u.%u: the word is saturated."
 
 };
 
 /* PRECISION - Determines the accuracy of the conversion from numbers in base
-decimal (of the set R+) to base X in the function 'dec_to_rad()'.
+decimal (of the set R+) to base X in the function 'dec_to_rad()'. It is the
+default of the option -p: the last digit is rounded, not truncated.
 -----------------------------------------------------------------------------*/
 #define PRECISION (20)
 
+/* SHORTEST - Value of the number of fractional digits that asks for the
+shortest digit string that reads back as the source number (option -s).
+-----------------------------------------------------------------------------*/
+#define SHORTEST (-1)
+
+/* BLOCK - Size of the blocks read from the input in column mode.
+-----------------------------------------------------------------------------*/
+#define BLOCK (64 * 1024)
+
+/* FIELD - Maximum length of a field converted in column mode: longer fields
+are copied as they are. It only matters for fields that cross two blocks.
+-----------------------------------------------------------------------------*/
+#define FIELD (1024)
+
+/* QUEUE - Number of input blocks, and of output blocks, of a batch job: while
+one is converted, the others are being read or written.
+-----------------------------------------------------------------------------*/
+#define QUEUE (4)
+
+/* RING - Number of cells of the shared memory ring of a server (option -R),
+that is of the requests that can be waiting at once. It must be a power of two.
+CELL is the room of a cell, for a number and then for its results.
+-----------------------------------------------------------------------------*/
+#define RING (64)
+#define CELL (4096)
+
+/* GROUPS - Number of different pairs of codifies kept by a batch job whose
+lines name their own: when there are more, the lines read so far are converted
+and the list starts over.
+-----------------------------------------------------------------------------*/
+#define GROUPS (64)
+
+/* SPIN - Number of times a cell of the ring is polled before sleeping until it
+changes: under load a request is answered without entering the kernel.
+-----------------------------------------------------------------------------*/
+#define SPIN (4096)
+
+/* FOLLOW - Longest time, in milliseconds, that the results of a followed file
+(option -F) are kept before they are written, and interval at which the file
+is checked for a rotation when no change is notified.
+-----------------------------------------------------------------------------*/
+#define FOLLOW (100)
+
+/* SWEEP - Number of values that a thread of a sweep (option -X) takes at a
+time from its range of the domain. Only the first MISMATCHES mismatches are
+written, the others are only counted.
+-----------------------------------------------------------------------------*/
+#define SWEEP (4096)
+#define MISMATCHES (20)
+
+/* RUN - Number of integers of a range written at a time: the negative ones,
+which cannot be incremented in place, are written together in base X (see
+ints_to_rad()).
+-----------------------------------------------------------------------------*/
+#define RUN (64)
+
+/* TABLE_LOW, TABLE_HIGH - The integers from -TABLE_LOW to TABLE_HIGH - 1 (those
+of 8 and 16 bits, natural or in two's complement) are written by copying their
+result from a table of the destination codify, built TABLE_BLOCK entries at a
+time as they are needed. An entry has TABLE_SLOT bytes: the length and up to
+TABLE_SLOT - 1 characters. A process keeps at most TABLES tables.
+-----------------------------------------------------------------------------*/
+#define TABLE_LOW (32768)
+#define TABLE_HIGH (65536)
+#define TABLE_BLOCK (64)
+#define TABLE_SLOT (32)
+#define TABLES (64)
+
+/* TABLE_FORMAT - Version of the results kept in the table files (option -T): a
+file with another one, or of another size, is built again. Increase it whenever
+a codify that has a table writes its results differently.
+-----------------------------------------------------------------------------*/
+#define TABLE_FORMAT (5)
+
+/* UNARY - Largest number written in unary outside stream mode, where all its
+digits are kept in memory. Stream mode (-S) writes any number.
+-----------------------------------------------------------------------------*/
+#define UNARY (64 * 1024 * 1024)
+
+/* BIG_DIGITS - Integer parts longer than 64 bits are converted as big numbers,
+which are split in halves until they have at most BIG_DIGITS digits: these are
+read and written with a loop that takes a time proportional to the square of
+their length.
+-----------------------------------------------------------------------------*/
+#define BIG_DIGITS (512)
+
+/* KARATSUBA - Number of limbs from which two big numbers are multiplied with
+the Karatsuba algorithm, rather than limb by limb.
+-----------------------------------------------------------------------------*/
+#define KARATSUBA (32)
+
 /* SCRAP - Value required in the "optarg_define()" function to differentiate
 the return value of baseX from the others. It is recommended not to change
 this value. If necessary, take into account that SCRAP must necessarily take
@@ -64,1133 +188,6569 @@ a value greater than the last variable in the previous enumeration.
 -----------------------------------------------------------------------------*/
 #define SCRAP (100)
 
+/* AUTO - Value returned by "optarg_define()" for the source codify "auto": the
+base of each number is given by its prefix (0x, 0b or 0o), and is decimal if it
+has none (see token_clean()).
+-----------------------------------------------------------------------------*/
+#define AUTO (SCRAP - 1)
+
+/* QFORMAT - Base of the values returned by "optarg_define()" for the fixed-point
+codifies qM.N and uqM.N: QFORMAT + 16384 * (2 * binary + unsigned) + 128 * M + N,
+where M (with the sign, if any) and N are the integer and fractional bits of
+the word, and 'binary' tells that it is written in binary instead of hex.
+-----------------------------------------------------------------------------*/
+#define QFORMAT (1000)
+
+/* TARGETS - Maximum number of destination codifies that can be given to -t.
+-----------------------------------------------------------------------------*/
+#define TARGETS (32)
+
 /* VERSION - String containing the name and version of this program.
 -----------------------------------------------------------------------------*/
 #define VERSION "BACO Base Converter 2.2"
 
-/* Libraries
+/* Libraries (vmsplice() is a GNU extension)
 -----------------------------------------------------------------------------*/
+#define _GNU_SOURCE
+
 #include <stdio.h>
+#include <stdarg.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
+#include <float.h>
+#include <stdint.h>
 #include <getopt.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <pthread.h>
+#include <signal.h>
+#include <limits.h>
+#include <time.h>
+#include <linux/futex.h>
+#include <sys/inotify.h>
+#include <poll.h>
+#include <sys/file.h>
+
+/* TRACE - Statically defined tracepoint 'name' of the provider "baco", with
+its arguments. With <sys/sdt.h> it is a no-op instruction until a tracer such
+as bpftrace attaches to it (see the scripts in trace/); without it the probe
+is not compiled, and its arguments are not evaluated (trace_none() is only
+declared, to type them).
+-----------------------------------------------------------------------------*/
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#endif
+#endif
+
+#ifdef STAP_PROBEV
+#define TRACE(name, ...) STAP_PROBEV(baco, name, __VA_ARGS__)
+#else
+#define TRACE(name, ...) ((void) sizeof (trace_none(0, __VA_ARGS__)))
+int trace_none(int, ...);
+#endif
+
+/* ARENA_BLOCK - Size of the blocks of memory taken by the arena allocator.
+-----------------------------------------------------------------------------*/
+#define ARENA_BLOCK (64 * 1024)
+
+/* Arena allocator
+-----------------------------------------------------------------------------*/
+
+/* ARENA - Memory for the temporaries of one conversion. The blocks are taken
+ * from the heap the first time they are needed and never given back, so once
+ * the arena has grown to the size of a conversion no more heap calls are made:
+ * arena_reset() only moves back to the first block.
+-----------------------------------------------------------------------------*/
+struct block {
+    struct block *next;
+    size_t size;
+    size_t used;
+    max_align_t data[];
+};
+
+struct arena {
+    struct block *head;
+    struct block *cur;
+};
+
+/* REQUEST - The conversions asked from the command line: the source codify,
+ * the destination ones (with the names they were given) and how to write the
+ * results. 'delimiter' separates the results of a number on a single line:
+ * when it is 0 and there are several destinations, a row is written for each.
+ * In column mode, only the fields of the 'columns' columns listed in 'column'
+ * are converted, and 'delimiter' separates the fields. 'stream' asks for a
+ * single number of any length, read from a file or the standard input.
+ * 'json' writes a JSON object for each result instead, with the source
+ * codify under the name it was given in 'source'. 'single' tells that the
+ * number is given on the command line: when it has no result nothing is
+ * written, while the other modes write an empty line to keep their output
+ * aligned with their input.
+-----------------------------------------------------------------------------*/
+struct request {
+    unsigned from;
+    const char *source;
+    unsigned count;
+    unsigned to[TARGETS];
+    const char *name[TARGETS];
+    int digits;
+    unsigned bit;
+    char delimiter;
+    unsigned columns;
+    unsigned column[TARGETS];
+    unsigned stream;
+    unsigned json;
+    unsigned single;
+};
+
+/* Every thread has its own arena, used by all the conversion functions */
+static _Thread_local struct arena scratch;
+
+/* The error of the last conversion of the thread (see fail()), and whether
+ * its message is left out of the standard error because it goes in the JSON
+ * output */
+static _Thread_local enum errors failure;
+static unsigned quiet;
+
+/* Set while a thread builds a table, whose entries may not be written: their
+ * errors are those of numbers that were not asked for */
+static _Thread_local unsigned muted;
+
+/* Rounding of the words of the fixed-point codifies (option -Q): to nearest,
+ * with ties to even, or truncated toward minus infinity */
+static enum rounding {
+    NEAREST, TRUNCATE
+} rounding;
+
+/* The threads started by the conversions of big numbers that are running (see
+ * big_spawn()) */
+static int big_threads;
+
+/* Set by a signal that stops a server or a follow job */
+static volatile sig_atomic_t halt;
+
+/* ALPHABET - The symbols of the digits of a base, from 2 to 256, used by
+ * Base58 and by the custom alphabet (option -a). 'digit' gives back the value
+ * of a symbol (ALPHABET_NONE if it is not one). power = base^k is the largest
+ * power of the base that fits in a limb: the digits are read and written k at
+ * a time.
+-----------------------------------------------------------------------------*/
+#define ALPHABET_NONE (0xFFFF)
+
+struct alphabet {
+    const char *sym;
+    unsigned base;
+    unsigned k;
+    uint64_t power;
+    unsigned short digit[256];
+};
+
+static struct alphabet base58, custom;
+
+/* OUTPUT - Text being written by the conversion functions: 'len' characters
+ * have been written in 'str', which has room for 'size' (the terminator
+ * included). The conversion functions add their result at the end, after
+ * taking room for it with out_reserve().
+-----------------------------------------------------------------------------*/
+struct output {
+    char *str;
+    size_t len;
+    size_t size;
+};
+
+/* MIXED - A batch job whose lines name their codifies: 'FROM TO NUMBER', where
+ * TO can be a list as for -t. The lines of a block are kept in 'rec' ('count'
+ * of them, in input order), each with its number, the names of its codifies and
+ * its 'group', the index in 'group' of the request for that pair (-1 if the
+ * names are not valid). 'spec' holds the names of the 'groups' requests. Once
+ * the block has been read, the lines are sorted by group, each group converted
+ * as a whole and the results written in input order (see batch_flush()).
+-----------------------------------------------------------------------------*/
+struct record {
+    char *num;
+    char *from;
+    char *to;
+    int group;
+    int error;
+    struct output out;
+};
+
+struct mixed {
+    struct record *rec;
+    size_t count;
+    size_t size;
+    struct request group[GROUPS];
+    char *spec[GROUPS];
+    unsigned groups;
+};
+
+/* COUNTER - The result of a destination in range mode, incremented in place:
+ * the 'len' characters at 'str', which lie at the end of 'buf' (so that they
+ * can grow to the left) or, when they do not fit, in the arena. The digits are
+ * in base 'base' with 'width' characters each (4 for BCD, whose digits are in
+ * binary), the 'lead' first ones (a sign) excluded; 'step' has the 'steps'
+ * digits of the step of the range, the least significant first. 'live' tells
+ * that the digits can be incremented: 'base' is 0 for the codifies without an
+ * incremental form, and negative numbers are always converted again.
+-----------------------------------------------------------------------------*/
+struct counter {
+    char buf[128];
+    char *str;
+    size_t len;
+    unsigned base;
+    unsigned width;
+    unsigned lead;
+    unsigned grow;
+    unsigned live;
+    unsigned char step[64];
+    unsigned steps;
+};
+
+/* SWEEP - An exhaustive round-trip check (option -X): every value of the
+ * domain is written in each of the 'count' codifies 'id' (with 'bit' bits)
+ * and read back, and each result is converted to every other codify. The
+ * domain is split in a lane for each thread: the values from 'next' to 'end'
+ * (excluded). A thread takes SWEEP values at a time from the front of its
+ * lane; once it is empty, it steals the back half of the largest lane left,
+ * so that none stays idle while another has work. 'lock' guards both ends.
+ * The counters of a lane are those of its thread; 'report' orders the lines
+ * of the mismatches, of which 'reported' have been found so far.
+-----------------------------------------------------------------------------*/
+struct lane {
+    pthread_mutex_t lock;
+    int64_t next;
+    int64_t end;
+    unsigned long long values;
+    unsigned long long trips;
+    unsigned long long refused;
+    unsigned long long mismatches;
+    unsigned self;
+    unsigned running;
+    struct sweep *sweep;
+    pthread_t thread;
+};
+
+struct sweep {
+    unsigned count;
+    unsigned id[TARGETS + 1];
+    const char *name[TARGETS + 1];
+    unsigned bit;
+    unsigned lanes;
+    struct lane *lane;
+    pthread_mutex_t report;
+    unsigned long long reported;
+};
+
+/* SLOT - A block of a batch job being read or written: 'len' bytes at 'buf',
+ * of which 'done' have been transferred, at offset 'off' of the file 'fd' (or
+ * -1 when it is transferred in sequence, like a pipe). It is 'busy' while the
+ * transfer is queued, and a block that has been read is 'ready' until it has
+ * been converted.
+-----------------------------------------------------------------------------*/
+struct slot {
+    char *buf;
+    size_t len;
+    size_t done;
+    off_t off;
+    int fd;
+    unsigned write;
+    unsigned busy;
+    unsigned ready;
+};
+
+/* PIPELINE - The I/O of a batch job: QUEUE input blocks in 'rd', converted in
+ * order from 'next' ('cur' is the one being converted, -1 if none, and 'ahead'
+ * the next one to read), and QUEUE output blocks in 'wr', filled in order
+ * ('fill' has 'used' bytes). A file is read and written at explicit offsets
+ * ('in_off' and 'out_off', -1 for anything else) so that all its blocks can be
+ * queued at once.
+ * The transfers are made by the kernel through an io_uring, whose rings are
+ * mapped in memory, or, when io_uring cannot be used ('ring' is -1), by a
+ * thread that takes them from the list 'todo' and puts them in 'done'.
+-----------------------------------------------------------------------------*/
+struct pipeline {
+    struct slot rd[QUEUE];
+    struct slot wr[QUEUE];
+    unsigned next;
+    unsigned ahead;
+    int cur;
+    unsigned fill;
+    size_t used;
+    off_t in_off;
+    off_t in_size;
+    off_t out_off;
+    unsigned eof;
+    int error;
+
+    int ring;
+    void *sq_ptr;
+    void *cq_ptr;
+    struct io_uring_sqe *sqes;
+    size_t sq_size;
+    size_t cq_size;
+    size_t sqes_size;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct slot *todo[2 * QUEUE];
+    struct slot *done[2 * QUEUE];
+    int res[2 * QUEUE];
+    unsigned todo_head;
+    unsigned todo_tail;
+    unsigned done_head;
+    unsigned done_tail;
+    unsigned stop;
+};
+
+/* RING - Memory shared by a server (option -R) and its clients (option -C, or
+ * ring_call()): a ring of RING cells, each with a request. A client takes the
+ * ticket 't' from 'tail' and waits until its cell, the one at t % RING, is
+ * free for it ('seq' is t); it writes the number in 'text' and sets 'seq' to
+ * t + 1. The server, taking the tickets in order ('head'), writes the results
+ * in the same cell, with the error code, and sets 'seq' to t + 2; then the
+ * client frees the cell for the ticket t + RING.
+ * A ticket is only taken once its cell is free, so a client that stops while
+ * waiting for its turn holds nothing. The one holding a cell records itself in
+ * 'client', with its 'ticket': if it ends before sending its number or before
+ * collecting the results, or gives them up ('client' 0), whoever waits for the
+ * cell frees it after a second, and the server skips the ticket.
+ * Who waits for a cell polls 'seq' SPIN times, then sleeps on it as a futex:
+ * 'waiters' counts the sleepers, so that the system call that wakes them is
+ * only made when there are some. 'server' is the process of the server, 0 once
+ * it has stopped.
+-----------------------------------------------------------------------------*/
+struct cell {
+    uint32_t seq;
+    uint32_t waiters;
+    uint32_t len;
+    uint32_t error;
+    uint32_t ticket;
+    pid_t client;
+    char text[CELL];
+};
+
+struct ring {
+    pid_t server;
+    uint32_t tail;
+    uint32_t head;
+    struct cell cell[RING];
+};
+
+/* TABLE - The results of the integers from -TABLE_LOW to TABLE_HIGH - 1 in the
+ * codify 'to' with 'bit' bits: 'slot' has the length of each one, then its
+ * characters; a length of TABLE_SLOT or more tells that it is not in the table
+ * (it cannot be written, or it is too long), so it is converted each time.
+ * The entries are built by blocks of TABLE_BLOCK: a thread claims a block by
+ * setting its 'builder' to its process, and sets 'built' once it is done; the
+ * claim of a process that has ended without finishing is taken over. With -T
+ * the table is a file mapped in memory, shared with the other processes that
+ * use it and left for the next ones; the header tells the format and the
+ * size of the table (see TABLE_FORMAT), to throw away the tables of another
+ * program.
+-----------------------------------------------------------------------------*/
+struct table {
+    char magic[16];
+    uint32_t format;
+    uint32_t size;
+    uint32_t to;
+    uint32_t bit;
+    pid_t builder[(TABLE_LOW + TABLE_HIGH) / TABLE_BLOCK];
+    unsigned char built[(TABLE_LOW + TABLE_HIGH) / TABLE_BLOCK];
+    unsigned char slot[TABLE_LOW + TABLE_HIGH][TABLE_SLOT];
+};
+
+/* The tables open, the first 'tables' of 'table', and the directory of their
+ * files (option -T), if any. New tables are added under 'table_lock' */
+static struct table *table[TABLES];
+static unsigned tables;
+static pthread_mutex_t table_lock = PTHREAD_MUTEX_INITIALIZER;
+static const char *table_dir;
+
+/* Intermediate representation
+-----------------------------------------------------------------------------*/
+
+/* FRACTION - Exact fractional part of a number, kept as the digits written in
+ * the source base (e.g. the "05" of 18.05 with base 10), most significant
+ * first. Trailing zeros are never stored, so len == 0 means no fraction.
+-----------------------------------------------------------------------------*/
+struct fraction {
+    unsigned base;
+    unsigned len;
+    unsigned char *digit;
+};
+
+/* BIG - A natural number of any size: 'n' limbs of 64 bits, the least
+ * significant first. The most significant limb is never 0, so 0 has n == 0.
+ * The limbs are taken from the heap, because the halves of a conversion are
+ * computed by different threads.
+-----------------------------------------------------------------------------*/
+struct big {
+    uint64_t *d;
+    size_t n;
+};
+
+/* POWER - The powers of a base used to split a big number: pow[j] is
+ * base^(k * 2^j), where base^k is the largest power that fits in a limb, and
+ * has 'bits[j]' bits. inv[j] = 2^(2 * bits[j]) / pow[j] is used to divide by it.
+-----------------------------------------------------------------------------*/
+struct power {
+    unsigned base;
+    unsigned k;
+    unsigned levels;
+    struct big pow[64];
+    struct big inv[64];
+    size_t bits[64];
+};
+
+/* JOB - Half of the work on a big number, given to a thread: the product of
+ * the n limbs 'a' and 'b' in 'r', or the n digits 'src' to read in 'x', or 'x'
+ * to write in the n digits 'str'.
+-----------------------------------------------------------------------------*/
+struct job {
+    struct big x;
+    const char *src;
+    char *str;
+    size_t n;
+    const struct power *pw;
+    uint64_t *r;
+    const uint64_t *a;
+    const uint64_t *b;
+    int depth;
+};
+
+/* VALUE - A number read from the command line. 'x' is its value, used by most
+ * of the conversion functions; 'whole' (absolute integer part) and 'frac'
+ * describe it exactly, so that the base X conversion does not depend on the
+ * rounding of 'x'. When the integer part does not fit in 64 bits it is kept
+ * in 'big' instead (big.d is NULL otherwise).
+-----------------------------------------------------------------------------*/
+struct value {
+    long double x;
+    unsigned sign;
+    long double whole;
+    struct big big;
+    struct fraction frac;
+};
 
 /* Execution functions
 -----------------------------------------------------------------------------*/
-const char *conversion(unsigned, unsigned, char *, char *);
+int batch_flush(const struct request *, struct mixed *, struct pipeline *);
+
+int batch_group(const struct request *, struct mixed *, struct pipeline *, const char *, const char *);
+
+int batch_line(const struct request *, struct mixed *, struct pipeline *, char *, size_t);
+
+int batch_mode(const struct request *, int, int);
+
+int batch_record(const struct request *, struct mixed *, struct pipeline *, char *);
+
+int client_mode(const char *, unsigned long);
 
-int format_scan(const char *, unsigned, unsigned, const char *);
+int codify_check(unsigned, const struct value *);
+
+int column_field(const struct request *, char *, size_t);
+
+int column_mode(const struct request *, int);
+
+int column_selected(const struct request *, unsigned);
+
+int conversion_from(unsigned, char *, struct value *);
+
+const char *conversion_to(unsigned, const struct value *, int, unsigned, struct output *);
+
+const char *conversion_write(unsigned, const struct value *, int, unsigned, struct output *);
+
+int convert_number(const struct request *, char *, struct output *);
+
+int format_check(const char *, size_t, unsigned);
+
+int format_scan(const char *, unsigned);
+
+int follow_line(const struct request *, char *);
+
+int follow_mode(const struct request *, const char *);
+
+int json_record(const struct request *, unsigned, const char *, const struct value *, struct output *);
 
 int optarg_define(const char *);
 
 void print_help(const char *);
 
+int range_mode(const struct request *, char *);
+
+int serve_mode(const struct request *, const char *);
+
+int stream_mode(const struct request *, int);
+
+void *sweep_job(void *);
+
+int sweep_mode(const struct request *, unsigned);
+
+int sweep_take(struct sweep *, unsigned, int64_t *, int64_t *);
+
+void sweep_value(struct lane *, int64_t);
+
+int unary_count(const struct request *, int);
+
+int unary_write(const struct request *, int);
+
 /* To decimal conversion functions
 -----------------------------------------------------------------------------*/
+int alpha_scan(const char *, const struct alphabet *, struct value *);
+
 long double bcd_to_dec(const char *);
 
+int bytes_scan(const char *, unsigned, struct value *);
+
 long double co1_to_dec(const char *);
 
 long double co2_to_dec(const char *);
 
 long double mes_to_dec(const char *);
 
+int q_scan(const char *, unsigned, struct value *);
+
+void rad_to_big(const char *, size_t, unsigned, struct big *);
+
 long double rad_to_dec(const char *, unsigned);
 
 long double rom_to_dec(const char *);
 
+void value_scan(const char *, unsigned, struct value *);
+
 /* From decimal conversion functions
 -----------------------------------------------------------------------------*/
-const char *dec_to_bcd(long double, char *);
+const char *big_to_rad(struct big, unsigned, unsigned *);
+
+const char *dec_to_bcd(long double, unsigned, struct output *);
+
+const char *dec_to_co1(long double, unsigned, struct output *);
+
+const char *dec_to_co2(long double, unsigned, struct output *);
+
+const char *dec_to_flt(long double, struct output *);
+
+const char *dec_to_mes(long double, unsigned, struct output *);
+
+const char *dec_to_rad(long double, unsigned, struct output *);
 
-const char *dec_to_co1(long double, char *);
+const char *dec_to_rom(long double, struct output *);
 
-const char *dec_to_co2(long double, char *);
+const char *ints_to_rad(const uint64_t *, size_t, int, unsigned, unsigned, size_t *, struct output *);
 
-const char *dec_to_flt(long double, char *);
+const char *val_to_alpha(const struct value *, const struct alphabet *, unsigned, struct output *);
 
-const char *dec_to_mes(long double, char *);
+const char *val_to_bytes(const struct value *, unsigned, struct output *);
 
-const char *dec_to_rad(long double, unsigned, char *);
+const char *val_to_q(const struct value *, unsigned, struct output *);
 
-const char *dec_to_rom(long double);
+const char *val_to_rad(const struct value *, unsigned, int, unsigned, struct output *);
 
 /* Auxiliary functions
 -----------------------------------------------------------------------------*/
-const char *binary_sum1(char *);
+int alpha_init(struct alphabet *, const char *);
 
-const char *bit_number(char *, unsigned, unsigned);
+void *arena_alloc(struct arena *, size_t);
+
+void arena_reset(struct arena *);
+
+unsigned bit_number(unsigned, unsigned);
 
 char *c1_converter(const char *);
 
 int check_base(const char *, unsigned);
 
-const char *remove_symbols(char *);
+int counter_add(struct counter *);
 
-/* Main
------------------------------------------------------------------------------*/
-int main(int argc, char *argv[]) {
-    unsigned from = 0, to = 0, bit = 0;
+void counter_init(struct counter *, unsigned, unsigned, unsigned long long);
 
-    const struct option long_options[] =
-            {
-                    {"help",    0, NULL, 'h'},
-                    {"version", 0, NULL, 'v'},
-                    {"bit",     1, NULL, 'b'},
-                    {"from",    1, NULL, 'b'},
-                    {"to",      1, NULL, 't'},
-                    {NULL,      0, NULL, 0}
-            };
+int counter_set(struct counter *, const struct request *, unsigned, long long);
 
-    unsigned c, opt;
+int fail(enum errors, ...);
 
-    while ((c = getopt_long(argc, argv, "hvb:f:t:", long_options, NULL)) != -1) {
-        if (optarg != NULL && c != 'b') {
-            /* Check if optarg is a valid codify */
-            if (!(opt = optarg_define(optarg))) {
-                fprintf(stderr, "'%s' is not a valid option.\n", optarg);
-                exit(EXIT_FAILURE);
-            }
+void frac_scan(const char *, unsigned, struct fraction *);
 
-            /* If the entered radix is not between 2 and 36
-             * print an error message and exit */
-            if (opt == SCRAP) {
-                fprintf(stderr, "Insert a radix between 1 and 36.\n");
-                exit(EXIT_FAILURE);
-            }
-        }
+unsigned frac_mul(unsigned char *, unsigned, unsigned, unsigned);
 
-        switch (c) {
-            case 'f':
-                from = opt;
-                break;
+int frac_to_bits(const struct fraction *, unsigned, uint64_t *);
 
-            case 't':
-                to = opt;
-                break;
+int frac_to_rad(const struct fraction *, unsigned, int, char *);
 
-            case 'b':
-                bit = atoi(optarg);
-                break;
+int group_decode(const char *, unsigned, unsigned char *);
 
-            case 'h':
-                print_help(argv[0]);
-                exit(EXIT_SUCCESS);
+void group_encode(const unsigned char *, unsigned, char *);
 
-            case 'v':
-                printf("%s\n", VERSION);
-                exit(EXIT_SUCCESS);
+void json_number(struct output *, unsigned long);
 
-            case '?':
-                exit(EXIT_FAILURE);
-        }
-    }
+void json_string(struct output *, const char *);
 
-    /* Check that the entered string contains valid characters */
-    if (format_scan(argv[optind], from, to, argv[0]))
-        exit(EXIT_FAILURE);
+const char *out_puts(struct output *, const char *);
 
-    char *val = malloc(1024);
+char *out_reserve(struct output *, size_t);
 
-    if (!val) {
-        fprintf(stderr, "Memory allocation error.\n");
-        exit(EXIT_FAILURE);
-    }
+unsigned rad_len(long double, unsigned);
 
-    if (!conversion(from, to, argv[optind], val))
-        exit(EXIT_FAILURE);
+const char *remove_symbols(char *);
 
-    printf("%s\n", val);
+void table_build(struct table *, unsigned);
 
-    free(val);
+const char *table_get(unsigned, const struct value *, unsigned, struct output *);
 
-    exit(EXIT_SUCCESS);
-}
+struct table *table_open(unsigned, unsigned);
 
+unsigned token_base(const char *);
 
-/*=============================================================================
- * EXECUTION FUNCTIONS
-=============================================================================*/
+char *token_clean(char *, size_t *, unsigned *);
 
-/* CONVERSION - Perform the conversions by calling the appropriate functions.
------------------------------------------------------------------------------*/
-const char *conversion(unsigned from, unsigned to, char *str, char *val) {
-    long double x;
+size_t token_find(const char *, size_t);
 
-    switch (from) {
-        case BCD: {
-            if ((x = bcd_to_dec(str)) == -1) {
-                fprintf(stderr, "BCD codify is not correct.\n");
-                return NULL;
-            }
+unsigned u64_to_rad(uint64_t, unsigned, char *);
 
-            break;
-        }
+size_t unary_zeros(const char *, size_t);
 
-        case BIN:
-            x = rad_to_dec(str, 2);
-            break;
+void value_big(struct value *, uint64_t *, size_t);
 
-        case CO1:
-            x = co1_to_dec(str);
-            break;
+unsigned char *value_bytes(const struct value *, size_t *);
 
-        case CO2:
-            x = co2_to_dec(str);
-            break;
+void value_set(struct value *, long double);
 
-        case DEC:
-            x = atof(str);
-            break;
+/* Big number functions
+-----------------------------------------------------------------------------*/
+uint64_t big_add(uint64_t *, const uint64_t *, size_t, const uint64_t *, size_t);
 
-        case MES:
-            x = mes_to_dec(str);
-            break;
+uint64_t *big_alloc(size_t);
 
-        case ROM: {
-            if (!(x = rom_to_dec(str)))
-                return NULL;
+size_t big_bits(struct big);
 
-            break;
-        }
+int big_cmp(struct big, struct big);
 
-        default: {
-            /* Unary base */
-            if (from - SCRAP == 1) {
-                if (strrchr(str, '.') || strrchr(str, '-')) {
-                    fprintf(stderr, "Unary numeral system admits only natural numbers.\n");
-                    exit(EXIT_FAILURE);
-                }
+int big_depth(void);
 
-                x = strlen(str);
+void big_divmod(struct big, const struct power *, unsigned, struct big *, struct big *, int);
 
-                /* This assignment only serves to run the precision within the
-                 * following to-DEC printf: it is assigned the value ROM (Roman
-                 * Numerals) as the unary base only accepts positive integers. */
-                from = ROM;
-            }
+void big_fork(void *(*)(void *), struct job *, struct job *, int);
 
-            /* Other numerical bases */
-            else {
-                x = rad_to_dec(str, from - SCRAP);
+void big_join(pthread_t);
 
-                /* This assignment only serves to run the precision within the following
-                 * to-DEC printf: the given the BIN value as the base X accepts any value */
-                from = BIN;
-            }
-        }
-    }
+void big_karatsuba(uint64_t *, const uint64_t *, const uint64_t *, size_t, int);
 
-    switch (to) {
-        case BCD:
-            return dec_to_bcd(x, val);
-        case BIN:
-            return dec_to_rad(x, 2, val);
-        case CO1:
-            return dec_to_co1(x, val);
-        case CO2:
-            return dec_to_co2(x, val);
-        case DEC:
-            return dec_to_rad(x, 10, val);
-        case FLT:
-            return dec_to_flt(x, val);
-        case MES:
-            return dec_to_mes(x, val);
-        case ROM:
-            return dec_to_rom(x);
+void big_mul(uint64_t *, const uint64_t *, size_t, const uint64_t *, size_t, int);
 
-        default : {
-            /* Unary base */
-            if (to - SCRAP == 1) {
-                if (strrchr(str, '.') || strrchr(str, '-')) {
-                    fprintf(stderr, "Unary numeral system admits only natural numbers.\n");
-                    return NULL;
-                }
+void big_mul_base(uint64_t *, const uint64_t *, size_t, const uint64_t *, size_t);
 
-                for (unsigned i = 0; i < x; i++)
-                    val[i] = '0';
+void *big_mul_job(void *);
 
-                val[(int) x] = '\0';
+struct big big_norm(struct big);
 
-                return val;
-            }
+void big_power(struct power *, unsigned, size_t, int, int);
 
-            /* Other numerical bases */
-            return dec_to_rad(x, to - SCRAP, val);
-        }
-    }
-}
+void big_power_free(struct power *);
 
-/* FORMAT_SCAN - Checks that the format of the entered number respects the
- * format required to perform the conversion requested by the user.
------------------------------------------------------------------------------*/
-int format_scan(const char *num, unsigned from, unsigned to, const char *name) {
-    int error = 0, decimal = 0, sign = -1;
+struct big big_product(struct big, struct big, int);
 
-    /* "from" (source) or "to" (destination) are empty */
-    if (!from || !to) {
-        fprintf(stderr, "Usage: conv -f <CODIFY> -t <CODIFY> <NUMBER>\n"
-                        "Use «%s --help » for more informations.\n", name);
-        return 1;
-    }
+struct big big_read(const char *, size_t, const struct power *, int);
 
-    /* "from" (source) or "to" (destination) are the same */
-    if (from == to) {
-        fprintf(stderr, "Source and destination are the same.\n");
-        return 1;
-    }
+void *big_read_job(void *);
 
-    for (unsigned i = 0; i < strlen(num); i++) {
-        if (num[i] == '-')
-            sign = i;
+struct big big_recip(struct big, size_t, int);
 
-        else if (num[i] == '.')
-            decimal++;
+struct big big_shl(struct big, size_t);
 
-        else if (isdigit(num[i]) && isalpha(num[i]))
-            error++;
-    }
+struct big big_shr(struct big, size_t);
 
-    switch (error) {
-        /* No errors found */
+int big_spawn(pthread_t *, void *(*)(void *), void *);
+
+uint64_t big_sub(uint64_t *, const uint64_t *, size_t, const uint64_t *, size_t);
+
+struct big big_sum(struct big, struct big);
+
+long double big_value(struct big);
+
+void big_write(struct big, size_t, char *, const struct power *, int);
+
+void *big_write_job(void *);
+
+/* I/O functions
+-----------------------------------------------------------------------------*/
+int io_close(struct pipeline *);
+
+void io_complete(struct pipeline *, struct slot *, int);
+
+void io_flush(struct pipeline *);
+
+char *io_get(struct pipeline *, size_t *);
+
+int io_open(struct pipeline *, int, int);
+
+void io_put(struct pipeline *, const char *, size_t);
+
+void io_queue(struct pipeline *, struct slot *);
+
+void io_read(struct pipeline *);
+
+int io_ring(struct pipeline *);
+
+void *io_thread(void *);
+
+void io_wait(struct pipeline *);
+
+/* Ring functions
+-----------------------------------------------------------------------------*/
+int ring_bench(struct ring *, char **, size_t, unsigned long);
+
+int ring_call(struct ring *, const char *, size_t, char *, size_t *);
+
+struct ring *ring_open(const char *, int);
+
+int ring_order(const void *, const void *);
+
+void ring_reclaim(struct cell *, uint32_t);
+
+void ring_sleep(struct ring *, struct cell *, uint32_t);
+
+void ring_stop(int);
+
+int ring_wait(struct ring *, struct cell *, uint32_t);
+
+void ring_wake(struct cell *);
+
+/* Main
+-----------------------------------------------------------------------------*/
+int main(int argc, char *argv[]) {
+    struct request req = {.digits = PRECISION};
+
+    alpha_init(&base58, "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz");
+
+    const struct option long_options[] =
+            {
+                    {"help",      0, NULL, 'h'},
+                    {"version",   0, NULL, 'v'},
+                    {"bit",       1, NULL, 'b'},
+                    {"from",      1, NULL, 'f'},
+                    {"to",        1, NULL, 't'},
+                    {"precision", 1, NULL, 'p'},
+                    {"shortest",  0, NULL, 's'},
+                    {"delimiter", 1, NULL, 'd'},
+                    {"column",    1, NULL, 'c'},
+                    {"stream",    0, NULL, 'S'},
+                    {"json",      0, NULL, 'j'},
+                    {"serve",     1, NULL, 'R'},
+                    {"client",    1, NULL, 'C'},
+                    {"bench",     1, NULL, 'B'},
+                    {"range",     1, NULL, 'r'},
+                    {"follow",    1, NULL, 'F'},
+                    {"alphabet",  1, NULL, 'a'},
+                    {"round",     1, NULL, 'Q'},
+                    {"sweep",     1, NULL, 'X'},
+                    {"tables",    1, NULL, 'T'},
+                    {NULL,        0, NULL, 0}
+            };
+
+    const char *serve = NULL, *client = NULL, *follow = NULL;
+    char *range = NULL;
+    unsigned long calls = 0;
+    unsigned c, opt, sweep = 0;
+
+    while ((c = getopt_long(argc, argv, "hvb:f:t:p:sd:c:SjR:C:B:r:F:a:Q:X:T:", long_options, NULL)) != -1) {
+        /* -t accepts a list of codifies separated by commas */
+        char *type = c == 't' ? strtok(optarg, ",") : optarg;
+
+        for (; (c == 'f' || c == 't') && type; type = c == 't' ? strtok(NULL, ",") : NULL) {
+            /* Check if optarg is a valid codify */
+            if (!(opt = optarg_define(type))) {
+                fprintf(stderr, "'%s' is not a valid option.\n", type);
+                exit(EXIT_FAILURE);
+            }
+
+            /* If the entered radix is not between 2 and 36
+             * print an error message and exit */
+            if (opt == SCRAP) {
+                fprintf(stderr, "Insert a radix between 1 and 36, or the symbols of a larger one (-a).\n");
+                exit(EXIT_FAILURE);
+            }
+
+            if (c == 't' && opt == AUTO) {
+                fprintf(stderr, "'%s' is only a source codify.\n", type);
+                exit(EXIT_FAILURE);
+            }
+
+            if (c == 'f') {
+                req.from = opt;
+                req.source = type;
+
+            } else if (req.count == TARGETS) {
+                fprintf(stderr, "Insert at most %d destinations.\n", TARGETS);
+                exit(EXIT_FAILURE);
+
+            } else {
+                req.to[req.count] = opt;
+                req.name[req.count++] = type;
+            }
+        }
+
+        switch (c) {
+            case 'b':
+                req.bit = atoi(optarg);
+                break;
+
+            case 'p':
+                if ((req.digits = atoi(optarg)) < 0) {
+                    fprintf(stderr, "Insert a non-negative number of digits.\n");
+                    exit(EXIT_FAILURE);
+                }
+
+                break;
+
+            case 's':
+                req.digits = SHORTEST;
+                break;
+
+            case 'd':
+                req.delimiter = strcmp(optarg, "\\t") ? optarg[0] : '\t';
+                break;
+
+            case 'c':
+                /* A list of columns separated by commas, counted from 1 */
+                for (char *col = strtok(optarg, ","); col; col = strtok(NULL, ",")) {
+                    if (atoi(col) < 1 || req.columns == TARGETS) {
+                        fprintf(stderr, "Insert at most %d columns, counted from 1.\n", TARGETS);
+                        exit(EXIT_FAILURE);
+                    }
+
+                    req.column[req.columns++] = atoi(col);
+                }
+
+                break;
+
+            case 'S':
+                req.stream = 1;
+                break;
+
+            case 'j':
+                req.json = quiet = 1;
+                break;
+
+            case 'R':
+                serve = optarg;
+                break;
+
+            case 'C':
+                client = optarg;
+                break;
+
+            case 'B':
+                calls = strtoul(optarg, NULL, 10);
+                break;
+
+            case 'r':
+                range = optarg;
+                break;
+
+            case 'F':
+                follow = optarg;
+                break;
+
+            case 'a':
+                if (alpha_init(&custom, optarg)) {
+                    fprintf(stderr, "An alphabet has from 2 to 256 different symbols, none blank.\n");
+                    exit(EXIT_FAILURE);
+                }
+
+                break;
+
+            case 'Q':
+                if (!strcmp(optarg, "nearest"))
+                    rounding = NEAREST;
+
+                else if (!strcmp(optarg, "truncate"))
+                    rounding = TRUNCATE;
+
+                else {
+                    fprintf(stderr, "Insert a rounding of 'nearest' or 'truncate'.\n");
+                    exit(EXIT_FAILURE);
+                }
+
+                break;
+
+            case 'X':
+                if ((sweep = atoi(optarg)) < 1 || sweep > 32) {
+                    fprintf(stderr, "Insert a width of the sweep from 1 to 32 bit.\n");
+                    exit(EXIT_FAILURE);
+                }
+
+                break;
+
+            case 'T':
+                table_dir = optarg;
+                break;
+
+            case 'h':
+                print_help(argv[0]);
+                exit(EXIT_SUCCESS);
+
+            case 'v':
+                printf("%s\n", VERSION);
+                exit(EXIT_SUCCESS);
+
+            case '?':
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    /* A client converts nothing itself: the server has the codifies */
+    if (client)
+        exit(client_mode(client, calls) ? EXIT_FAILURE : EXIT_SUCCESS);
+
+    /* "from" (source) or "to" (destination) are empty: only the lines of a
+     * batch job can name their own */
+    if (!req.from != !req.count || (!req.from && (optind < argc || req.columns || req.stream || serve || range || follow))) {
+        fprintf(stderr, "Usage: conv -f <CODIFY> -t <CODIFY>[,<CODIFY>...] [NUMBER]\n"
+                        "Use «%s --help » for more informations.\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    /* "from" (source) or "to" (destination) are the same */
+    if (req.count == 1 && req.from == req.to[0]) {
+        fprintf(stderr, "Source and destination are the same.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (unsigned i = 0; i <= req.count && !custom.base; i++)
+        if ((i < req.count ? req.to[i] : req.from) == ALF) {
+            fprintf(stderr, "The codify 'alpha' needs its symbols (-a).\n");
+            exit(EXIT_FAILURE);
+        }
+
+    if (req.stream && req.from == AUTO) {
+        fprintf(stderr, "Stream mode (-S) needs the source base: it cannot be 'auto'.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (sweep && req.from == AUTO) {
+        fprintf(stderr, "A sweep (-X) writes the numbers in the source codify: it cannot be 'auto'.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (req.json && (req.columns || req.stream || range)) {
+        fprintf(stderr, "JSON output is written only for numbers, not for files or ranges (-c, -S, -r).\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* A sweep writes only its mismatches and totals */
+    if (sweep)
+        exit(sweep_mode(&req, sweep) ? EXIT_FAILURE : EXIT_SUCCESS);
+
+    /* Range mode writes the results of each number as batch mode does */
+    if (range) {
+        if (!req.delimiter)
+            req.delimiter = '\t';
+
+        exit(range_mode(&req, range) ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+
+    /* Follow mode writes the results of each line as batch mode does */
+    if (follow) {
+        if (!req.delimiter)
+            req.delimiter = '\t';
+
+        exit(follow_mode(&req, follow) ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+
+    /* A server writes the results of a number as batch mode does */
+    if (serve) {
+        if (!req.delimiter)
+            req.delimiter = '\t';
+
+        exit(serve_mode(&req, serve) ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+
+    /* Column and stream mode: the operands are the files to convert */
+    if (req.columns || req.stream) {
+        int (*mode)(const struct request *, int) = req.stream ? stream_mode : column_mode;
+        int status = EXIT_SUCCESS;
+
+        if (!req.delimiter)
+            req.delimiter = ',';
+
+        if (optind == argc && mode(&req, STDIN_FILENO))
+            status = EXIT_FAILURE;
+
+        for (int i = optind; i < argc; i++) {
+            int fd = open(argv[i], O_RDONLY);
+
+            if (fd < 0) {
+                perror(argv[i]);
+                status = EXIT_FAILURE;
+                continue;
+            }
+
+            if (mode(&req, fd))
+                status = EXIT_FAILURE;
+
+            close(fd);
+        }
+
+        exit(status);
+    }
+
+    if (optind < argc) {
+        struct output out = {NULL, 0, 0};
+        int error;
+
+        req.single = 1;
+        error = convert_number(&req, argv[optind], &out);
+
+        fwrite(out.str, 1, out.len, stdout);
+        exit(error ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+
+    /* In batch mode each number has its results on a line */
+    if (!req.delimiter)
+        req.delimiter = '\t';
+
+    /* Batch mode: a number per line is read from the standard input */
+    exit(batch_mode(&req, STDIN_FILENO, STDOUT_FILENO) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+
+/*=============================================================================
+ * EXECUTION FUNCTIONS
+=============================================================================*/
+
+/* BATCH_FLUSH - Converts the lines kept by a mixed batch job (see struct mixed)
+ * and puts the results in the output. The lines are sorted by group with a
+ * counting sort, so that those of a group are converted one after the other
+ * with the same request, then the results are put in input order. The arena
+ * is emptied at the end. Returns 1 on error, 0 otherwise.
+-----------------------------------------------------------------------------*/
+int batch_flush(const struct request *req, struct mixed *mix, struct pipeline *p) {
+    size_t start[GROUPS + 2] = {0}, *order;
+    int error = 0;
+
+    if (!mix->count)
+        return 0;
+
+    if (!(order = arena_alloc(&scratch, mix->count * sizeof(size_t)))) {
+        fprintf(stderr, "Memory allocation error.\n");
+        return 1;
+    }
+
+    /* The lines with invalid names (group -1) come first */
+    for (size_t i = 0; i < mix->count; i++)
+        start[mix->rec[i].group + 2]++;
+
+    for (unsigned g = 1; g < GROUPS + 2; g++)
+        start[g] += start[g - 1];
+
+    for (size_t i = 0; i < mix->count; i++)
+        order[start[mix->rec[i].group + 1]++] = i;
+
+    for (size_t i = 0; i < mix->count; i++) {
+        struct record *r = &mix->rec[order[i]];
+
+        failure = E_NONE;
+
+        if (r->group >= 0 && *r->num)
+            r->error = convert_number(&mix->group[r->group], r->num, &r->out);
+
+        /* A line without names is kept as an empty line of batch mode */
+        else if (!req->json)
+            r->error = r->group < 0 ? *r->from && fail(E_SPEC, optarg_define(r->from) ? r->to : r->from) :
+                       fail(E_CODIFY);
+
+        else {
+            struct request stub = {.source = r->from, .name = {r->to}, .count = 1, .bit = req->bit};
+            const struct request *q = r->group < 0 ? &stub : &mix->group[r->group];
+
+            if (r->group >= 0 || !*r->from)
+                fail(E_CODIFY);
+            else
+                fail(E_SPEC, optarg_define(r->from) ? r->to : r->from);
+
+            for (unsigned j = 0; j < q->count; j++)
+                r->error |= json_record(q, j, r->num, NULL, &r->out);
+        }
+    }
+
+    for (size_t i = 0; i < mix->count; i++) {
+        struct record *r = &mix->rec[i];
+
+        if (r->out.len)
+            io_put(p, r->out.str, r->out.len);
+        else
+            io_put(p, "\n", 1);
+
+        error |= r->error;
+    }
+
+    mix->count = 0;
+    arena_reset(&scratch);
+
+    return error;
+}
+
+/* BATCH_GROUP - Returns the group of the lines of a mixed batch job with the
+ * codifies named 'from' and 'to' (see struct mixed), made when it is the
+ * first of them, or -1 if the names are not valid. The names are read with
+ * optarg_define(), as those of -f and -t, only once for all the lines.
+-----------------------------------------------------------------------------*/
+int batch_group(const struct request *req, struct mixed *mix, struct pipeline *p, const char *from, const char *to) {
+    size_t from_len = strlen(from), to_len = strlen(to);
+    struct request *g;
+    char *spec;
+
+    for (unsigned i = 0; i < mix->groups; i++)
+        if (!strcmp(mix->spec[i], from) && !strcmp(mix->spec[i] + from_len + 1, to))
+            return i;
+
+    if (!*from || !*to)
+        return -1;
+
+    /* The lines kept refer to the groups, so they are converted first */
+    if (mix->groups == GROUPS) {
+        batch_flush(req, mix, p);
+
+        while (mix->groups)
+            free(mix->spec[--mix->groups]);
+    }
+
+    /* The names, followed by a copy of 'to' split at the commas */
+    if (!(spec = malloc(from_len + 2 * to_len + 3))) {
+        fprintf(stderr, "Memory allocation error.\n");
+        return -1;
+    }
+
+    memcpy(spec, from, from_len + 1);
+    memcpy(spec + from_len + 1, to, to_len + 1);
+    memcpy(spec + from_len + to_len + 2, to, to_len + 1);
+
+    g = &mix->group[mix->groups];
+    *g = *req;
+    g->source = spec;
+    g->count = 0;
+
+    if (!(g->from = optarg_define(from)) || g->from == SCRAP) {
+        free(spec);
+        return -1;
+    }
+
+    for (char *type = strtok(spec + from_len + to_len + 2, ","); type; type = strtok(NULL, ",")) {
+        unsigned opt = optarg_define(type);
+
+        if (!opt || opt == SCRAP || opt == AUTO || g->count == TARGETS) {
+            free(spec);
+            return -1;
+        }
+
+        g->to[g->count] = opt;
+        g->name[g->count++] = type;
+    }
+
+    if (!g->count) {
+        free(spec);
+        return -1;
+    }
+
+    mix->spec[mix->groups] = spec;
+
+    return mix->groups++;
+}
+
+/* BATCH_LINE - Converts a line of a batch job and puts the results in the
+ * output. Empty lines are kept as they are, except in JSON output, where they
+ * are records of an invalid number. The arena is emptied after each
+ * line, so its memory is reused. Without codifies in 'req', the line names its
+ * own and is only kept in 'mix' (see batch_record()). Returns 1 on error, 0
+ * otherwise.
+-----------------------------------------------------------------------------*/
+int batch_line(const struct request *req, struct mixed *mix, struct pipeline *p, char *num, size_t len) {
+    struct output out = {NULL, 0, 0};
+    int error = 0;
+
+    if (!req->count)
+        return batch_record(req, mix, p, num);
+
+    if (!len && !req->json)
+        io_put(p, "\n", 1);
+
+    else {
+        error = convert_number(req, num, &out);
+        io_put(p, out.str, out.len);
+    }
+
+    arena_reset(&scratch);
+
+    return error;
+}
+
+/* BATCH_MODE - Converts a number per line of 'in' and writes the results on
+ * 'out', a line for each line. The blocks of the input are read, and those of
+ * the output written, by the pipeline (see io_open()) while the lines are
+ * converted: a line is converted where it lies in its block, only a line that
+ * crosses two blocks is first copied in 'line'. When the lines name their
+ * codifies, those of a block are converted once it has been read (see struct
+ * mixed). Returns 1 on error.
+-----------------------------------------------------------------------------*/
+int batch_mode(const struct request *req, int in, int out) {
+    struct pipeline p;
+    struct mixed mix = {0};
+    char *line = NULL, *block, *end, *nl;
+    size_t size = 0, len = 0, n;
+    int error = 0;
+
+    if (io_open(&p, in, out))
+        return 1;
+
+    while ((block = io_get(&p, &n))) {
+        for (end = block + n; block < end; block = nl + 1) {
+            size_t part = ((nl = memchr(block, '\n', end - block)) ? nl : end) - block;
+
+            /* A line that goes on in the next block */
+            if (len || !nl) {
+                /* The lines kept may lie in 'line' */
+                if (!nl)
+                    error |= batch_flush(req, &mix, &p);
+
+                if (len + part + 1 > size) {
+                    char *tmp = realloc(line, size = 2 * (len + part + 1));
+
+                    if (!tmp) {
+                        fprintf(stderr, "Memory allocation error.\n");
+                        free(line);
+                        io_close(&p);
+                        return 1;
+                    }
+
+                    line = tmp;
+                }
+
+                memcpy(line + len, block, part);
+                len += part;
+                line[len] = '\0';
+
+                if (!nl)
+                    break;
+
+                error |= batch_line(req, &mix, &p, line, len);
+                len = 0;
+
+            } else {
+                *nl = '\0';
+                error |= batch_line(req, &mix, &p, block, part);
+            }
+        }
+
+        /* The block is given back to the pipeline by the next io_get() */
+        error |= batch_flush(req, &mix, &p);
+    }
+
+    /* The last line may have no newline */
+    if (len)
+        error |= batch_line(req, &mix, &p, line, len);
+
+    error |= batch_flush(req, &mix, &p);
+
+    while (mix.groups)
+        free(mix.spec[--mix.groups]);
+
+    free(mix.rec);
+    free(line);
+
+    return io_close(&p) | error;
+}
+
+/* BATCH_RECORD - Keeps a line of a mixed batch job (see struct mixed), whose
+ * names and number are split in place. Returns 1 on error, 0 otherwise.
+-----------------------------------------------------------------------------*/
+int batch_record(const struct request *req, struct mixed *mix, struct pipeline *p, char *line) {
+    struct record r = {.from = line + strspn(line, " \t")};
+
+    r.to = r.from + strcspn(r.from, " \t");
+    r.num = r.to += strspn(r.to, " \t");
+    r.num += strcspn(r.num, " \t");
+    r.num += strspn(r.num, " \t");
+    r.from[strcspn(r.from, " \t")] = '\0';
+    r.to[strcspn(r.to, " \t")] = '\0';
+
+    r.group = batch_group(req, mix, p, r.from, r.to);
+
+    if (mix->count == mix->size) {
+        struct record *tmp = realloc(mix->rec, (mix->size = 2 * mix->size + 64) * sizeof(struct record));
+
+        if (!tmp) {
+            fprintf(stderr, "Memory allocation error.\n");
+            return 1;
+        }
+
+        mix->rec = tmp;
+    }
+
+    mix->rec[mix->count++] = r;
+
+    return 0;
+}
+
+/* CLIENT_MODE - Sends each line of the standard input to the server of the
+ * ring 'name' (see struct ring) and writes the results it gives back. With
+ * 'calls', the lines are sent in turn until 'calls' have been sent, and the
+ * times of the round trips are written instead (see ring_bench()). Returns 1
+ * on error.
+-----------------------------------------------------------------------------*/
+int client_mode(const char *name, unsigned long calls) {
+    struct ring *r = ring_open(name, 0);
+    static char res[CELL];
+    char *line = NULL, **lines = NULL;
+    size_t size = 0, count = 0, len;
+    ssize_t n;
+    int error = 0, fatal = 0, e;
+
+    if (!r)
+        return 1;
+
+    while (!fatal && (n = getline(&line, &size, stdin)) > 0) {
+        len = n - (line[n - 1] == '\n');
+
+        if (calls) {
+            char **tmp = realloc(lines, (count + 1) * sizeof(char *));
+
+            if (!tmp || !(tmp[count] = strndup(line, len))) {
+                fprintf(stderr, "Memory allocation error.\n");
+                lines = tmp ? tmp : lines;
+                fatal = 1;
+
+            } else
+                lines = tmp, count++;
+
+        } else if ((e = ring_call(r, line, len, res, &len)) < 0) {
+            fprintf(stderr, "%s: the server has stopped.\n", name);
+            fatal = 1;
+
+        } else {
+            fwrite(res, 1, len, stdout);
+            error |= e != E_NONE;
+        }
+    }
+
+    if (calls && count && !fatal)
+        fatal = ring_bench(r, lines, count, calls);
+
+    for (size_t i = 0; i < count; i++)
+        free(lines[i]);
+
+    free(lines);
+    free(line);
+    munmap(r, sizeof(struct ring));
+
+    return error || fatal;
+}
+
+/* CODIFY_CHECK - Checks that a number can be written in the destination
+ * codify (e.g. Roman numerals have no fractions or negative numbers).
+-----------------------------------------------------------------------------*/
+int codify_check(unsigned to, const struct value *v) {
+    for (unsigned i = 0; i < (sizeof(code) / sizeof(struct codify)); i++)
+        if (to == code[i].id) {
+            if (v->frac.len && !code[i].decimal) {
+                fail(E_INTEGER, code[i].name[0]);
+                return 1;
+            }
+
+            if (v->sign && !code[i].signt) {
+                fail(E_POSITIVE, code[i].name[0]);
+                return 1;
+            }
+        }
+
+    /* Unary base */
+    if (to - SCRAP == 1 && (v->sign || v->frac.len)) {
+        fail(E_NATURAL);
+        return 1;
+    }
+
+    /* Only the base X codifies write big numbers of any size */
+    if (isinf(v->x) && (to == BCD || to == CO1 || to == CO2 || to == FLT || to == MES || to == ROM ||
+                        to - SCRAP == 1)) {
+        fail(E_LARGE);
+        return 1;
+    }
+
+    return 0;
+}
+
+/* COLUMN_FIELD - Converts a field in column mode and writes the result. The
+ * field is len bytes at 'f', and f[len] can be overwritten. A quoted field is
+ * written quoted, and a field that is not a valid number is copied as it is.
+ * Returns 1 on error, 0 otherwise.
+-----------------------------------------------------------------------------*/
+int column_field(const struct request *req, char *f, size_t len) {
+    struct output out = {NULL, 0, 0};
+    struct value v;
+    unsigned cr = len && f[len - 1] == '\r', quoted, error, from = req->from;
+    size_t n = len - cr, k;
+    char *field = f, *num, end;
+
+    /* The carriage return at the end of the line is kept after the result */
+    if ((quoted = n > 1 && f[0] == '"' && f[n - 1] == '"')) {
+        field++;
+        n -= 2;
+    }
+
+    end = field[n];
+    field[n] = '\0';
+    num = field;
+    k = n;
+
+    /* A field that is not a number is written as it is: if the tokenizer is to
+     * move its bytes, they are moved in a copy */
+    if (token_find(field, n) < n || (*field == '-' && token_base(field + 1))) {
+        if ((num = arena_alloc(&scratch, n + 1)))
+            memcpy(num, field, n + 1);
+    }
+
+    if (num)
+        num = token_clean(num, &k, &from);
+
+    error = (!num && fail(E_MEMORY)) || !k || format_scan(num, from) || conversion_from(from, num, &v);
+    field[n] = end;
+
+    /* The results of a list are separate fields */
+    for (unsigned i = 0; i < req->count && !error; i++) {
+        char *p = i ? out_reserve(&out, 1) : NULL;
+
+        if (p)
+            *p = req->delimiter;
+
+        error = (i && !p) || (quoted && !out_puts(&out, "\"")) || codify_check(req->to[i], &v) ||
+                !conversion_to(req->to[i], &v, req->digits, req->bit, &out) ||
+                (quoted && !out_puts(&out, "\""));
+    }
+
+    if (error) {
+        fwrite(f, 1, len, stdout);
+        return n > 0;
+    }
+
+    if (cr)
+        out_puts(&out, "\r");
+
+    fwrite(out.str, 1, out.len, stdout);
+
+    return 0;
+}
+
+/* COLUMN_MODE - Converts the selected columns of a CSV/TSV file, copying all
+ * the other bytes as they are. The file is read in blocks of BLOCK bytes and
+ * a field is converted where it lies in the block: only a field that crosses
+ * two blocks is first copied in a buffer of FIELD bytes. Delimiters and
+ * newlines between double quotes belong to the field (a doubled quote toggles
+ * twice, so escaped quotes need no special care). Returns 1 on error.
+-----------------------------------------------------------------------------*/
+int column_mode(const struct request *req, int fd) {
+    static char buf[BLOCK + 1], field[FIELD + 1];
+    size_t flen = 0, run, start = 0;
+    unsigned col = 1, quoted = 0, selected, spill = 0;
+    int error = 0;
+    ssize_t n;
+
+    selected = column_selected(req, col);
+
+    while ((n = read(fd, buf, BLOCK)) > 0) {
+        run = 0;
+
+        for (size_t i = 0; i < (size_t) n; i++) {
+            char c = buf[i];
+
+            if (c == '"')
+                quoted = !quoted;
+
+            if (quoted || (c != req->delimiter && c != '\n'))
+                continue;
+
+            /* End of a field to convert: the delimiter is written after it */
+            if (selected) {
+                if (!spill)
+                    error |= column_field(req, buf + start, i - start);
+
+                else if (flen + i <= FIELD) {
+                    memcpy(field + flen, buf, i);
+                    error |= column_field(req, field, flen + i);
+
+                } else {
+                    fwrite(field, 1, flen, stdout);
+                    fwrite(buf, 1, i, stdout);
+                    error = 1;
+                }
+
+                arena_reset(&scratch);
+                spill = 0;
+                run = i;
+            }
+
+            col = c == '\n' ? 1 : col + 1;
+
+            /* Start of a field to convert: write what comes before */
+            if ((selected = column_selected(req, col))) {
+                fwrite(buf + run, 1, i + 1 - run, stdout);
+                start = i + 1;
+            }
+        }
+
+        if (!selected)
+            fwrite(buf + run, 1, n - run, stdout);
+
+        /* The field goes on in the next block */
+        else if ((spill ? flen : 0) + n - start <= FIELD) {
+            flen = (spill ? flen : 0);
+            memcpy(field + flen, buf + start, n - start);
+            flen += n - start;
+            spill = 1;
+            start = 0;
+        }
+
+        /* Too long to be a number: it is copied as it is */
+        else {
+            fwrite(field, 1, spill ? flen : 0, stdout);
+            fwrite(buf + start, 1, n - start, stdout);
+            selected = spill = 0;
+            error = 1;
+        }
+    }
+
+    /* The last field is not followed by a delimiter */
+    if (selected && spill)
+        error |= column_field(req, field, flen);
+
+    if (n < 0) {
+        perror("read");
+        return 1;
+    }
+
+    return error;
+}
+
+/* COLUMN_SELECTED - Tells whether the fields of a column are to be converted.
+-----------------------------------------------------------------------------*/
+int column_selected(const struct request *req, unsigned col) {
+    for (unsigned i = 0; i < req->columns; i++)
+        if (req->column[i] == col)
+            return 1;
+
+    return 0;
+}
+
+/* CONVERSION_FROM - Reads a number written in the source codify, calling the
+ * appropriate functions. Returns 1 on error, 0 otherwise.
+-----------------------------------------------------------------------------*/
+int conversion_from(unsigned from, char *str, struct value *v) {
+    int error = 0;
+
+    TRACE(parse_entry, from, str);
+
+    v->frac.base = 0;
+    v->big = (struct big) {NULL, 0};
+
+    switch (from) {
+        case BCD: {
+            if ((v->x = bcd_to_dec(str)) == -1)
+                error = fail(E_BCD);
+
+            break;
+        }
+
+        case BIN:
+            value_scan(str, 2, v);
+            break;
+
+        case CO1:
+            v->x = co1_to_dec(str);
+            break;
+
+        case CO2:
+            v->x = co2_to_dec(str);
+            break;
+
+        case DEC:
+            value_scan(str, 10, v);
+            break;
+
+        case MES:
+            v->x = mes_to_dec(str);
+            break;
+
+        case ROM: {
+            if (!(v->x = rom_to_dec(str)) && strcasecmp(str, "NULL"))
+                error = 1;
+
+            break;
+        }
+
+        case B32:
+            error = bytes_scan(str, 5, v);
+            break;
+
+        case B58:
+            error = alpha_scan(str, &base58, v);
+            break;
+
+        case B64:
+            error = bytes_scan(str, 6, v);
+            break;
+
+        case ALF:
+            error = alpha_scan(str, &custom, v);
+            break;
+
+        default: {
+            /* Fixed-point words */
+            if (from >= QFORMAT)
+                error = q_scan(str, from, v);
+
+            /* Unary base */
+            else if (from - SCRAP == 1) {
+                if (strrchr(str, '.') || strrchr(str, '-'))
+                    error = fail(E_NATURAL);
+                else
+                    v->x = strlen(str);
+            }
+
+            /* Other numerical bases */
+            else
+                value_scan(str, from - SCRAP, v);
+        }
+    }
+
+    /* Codifies that are not read by value_scan() only give the value: derive
+     * the integer and fractional parts from it */
+    if (!error && !v->frac.base)
+        value_set(v, v->x);
+
+    TRACE(parse_return, from, error ? failure : E_NONE);
+
+    return error;
+}
+
+/* CONVERSION_TO - Writes a number in the destination codify at the end of the
+ * output. 'digits' is the number of fractional digits written in base X, or
+ * SHORTEST, and 'bit' the number of bits/digits of the result (0 for the least
+ * needed). The result of an integer of 16 bits is copied from a table, when
+ * the codify has one (see table_get()); the others are written by
+ * conversion_write().
+-----------------------------------------------------------------------------*/
+const char *conversion_to(unsigned to, const struct value *v, int digits, unsigned bit, struct output *out) {
+    enum errors saved = failure;
+    size_t start = out->len;
+    const char *res;
+
+    TRACE(format_entry, to, bit);
+
+    /* A result can come with an error too (a saturated fixed-point word), so
+     * the code is that of this conversion only */
+    failure = E_NONE;
+
+    if (!(res = table_get(to, v, bit, out)))
+        res = conversion_write(to, v, digits, bit, out);
+
+    TRACE(format_return, to, res ? out->len - start : 0, failure);
+
+    if (res && failure == E_NONE)
+        failure = saved;
+
+    return res;
+}
+
+/* CONVERSION_WRITE - Does the work of conversion_to(), calling the function of
+ * the destination codify.
+-----------------------------------------------------------------------------*/
+const char *conversion_write(unsigned to, const struct value *v, int digits, unsigned bit, struct output *out) {
+    const char *res = NULL;
+
+    switch (to) {
+        case BCD:
+            res = dec_to_bcd(v->x, bit, out);
+            break;
+        case BIN:
+            res = val_to_rad(v, 2, digits, bit, out);
+            break;
+        case CO1:
+            res = dec_to_co1(v->x, bit, out);
+            break;
+        case CO2:
+            res = dec_to_co2(v->x, bit, out);
+            break;
+        case DEC:
+            res = val_to_rad(v, 10, digits, bit, out);
+            break;
+        case FLT:
+            res = dec_to_flt(v->x, out);
+            break;
+        case MES:
+            res = dec_to_mes(v->x, bit, out);
+            break;
+        case ROM:
+            res = dec_to_rom(v->x, out);
+            break;
+        case B32:
+            res = val_to_bytes(v, 5, out);
+            break;
+        case B58:
+            res = val_to_alpha(v, &base58, bit, out);
+            break;
+        case B64:
+            res = val_to_bytes(v, 6, out);
+            break;
+        case ALF:
+            res = val_to_alpha(v, &custom, bit, out);
+            break;
+
+        default : {
+            /* Fixed-point words */
+            if (to >= QFORMAT) {
+                res = val_to_q(v, to, out);
+                break;
+            }
+
+            /* Unary base */
+            if (to - SCRAP == 1) {
+                char *p;
+
+                if (v->x > UNARY)
+                    fail(E_UNARY, UNARY);
+
+                else if ((p = out_reserve(out, v->x))) {
+                    memset(p, '0', v->x);
+                    res = out->str;
+                }
+
+                break;
+            }
+
+            /* Other numerical bases */
+            res = val_to_rad(v, to - SCRAP, digits, bit, out);
+        }
+    }
+
+    return res;
+}
+
+/* CONVERT_NUMBER - Converts a number to every destination and writes the
+ * results in 'out', as the lines to print. The number is checked and read only
+ * once. On error the result is left empty, so that in batch mode the lines of
+ * the output still match those of the input; a single number (see struct
+ * request) without any result writes nothing. In JSON output a record is
+ * written for each destination instead (see json_record()). Returns 1 on
+ * error, 0 otherwise.
+-----------------------------------------------------------------------------*/
+int convert_number(const struct request *req, char *num, struct output *out) {
+    struct value v;
+    int error = 0, rows = req->count > 1 && !req->delimiter;
+    size_t width = 0, len = strlen(num), n = len, start = out->len;
+    unsigned results = 0;
+    unsigned from = req->from;
+    char *p;
+
+    /* The JSON input is kept before it is changed by the conversion */
+    if (req->json) {
+        char *input = arena_alloc(&scratch, len + 1);
+        int invalid;
+
+        if (!input)
+            return fail(E_MEMORY);
+
+        memcpy(input, num, len + 1);
+        failure = E_NONE;
+        num = token_clean(num, &n, &from);
+        invalid = !n ? fail(E_CODIFY) : format_scan(num, from) || conversion_from(from, num, &v);
+
+        for (unsigned i = 0; i < req->count; i++)
+            error |= json_record(req, i, input, invalid ? NULL : &v, out);
+
+        return error;
+    }
+
+    num = token_clean(num, &n, &from);
+
+    /* Check that the entered string contains valid characters */
+    if ((!n && len && fail(E_CODIFY)) || format_scan(num, from) || conversion_from(from, num, &v)) {
+        if (req->single)
+            return 1;
+
+        for (unsigned i = 1; i < req->count && req->delimiter; i++)
+            if ((p = out_reserve(out, 1)))
+                *p = req->delimiter;
+
+        out_puts(out, "\n");
+        return 1;
+    }
+
+    for (unsigned i = 0; i < req->count; i++)
+        if (strlen(req->name[i]) > width)
+            width = strlen(req->name[i]);
+
+    for (unsigned i = 0; i < req->count; i++) {
+        size_t mark;
+
+        /* A row for each destination, or all the results on a line */
+        if (rows && out_puts(out, req->name[i]) && (p = out_reserve(out, width - strlen(req->name[i]) + 2)))
+            memset(p, ' ', width - strlen(req->name[i]) + 2);
+
+        else if (!rows && i && (p = out_reserve(out, 1)))
+            *p = req->delimiter;
+
+        mark = out->len;
+
+        /* A result that cannot be written is left empty */
+        if (codify_check(req->to[i], &v) || !conversion_to(req->to[i], &v, req->digits, req->bit, out)) {
+            if (out->str)
+                out->str[out->len = mark] = '\0';
+
+            error = 1;
+        }
+
+        else
+            results++;
+
+        if (rows)
+            out_puts(out, "\n");
+    }
+
+    if (!rows)
+        out_puts(out, "\n");
+
+    if (req->single && !results && out->str)
+        out->str[out->len = start] = '\0';
+
+    return error;
+}
+
+/* FORMAT_CHECK - Does the work of format_scan() on the number 'num' of
+ * length 'len'.
+-----------------------------------------------------------------------------*/
+int format_check(const char *num, size_t len, unsigned from) {
+    int error = 0, decimal = 0, sign = -1;
+
+    /* Their symbols can be any, and are checked while they are read */
+    if (from == B32 || from == B58 || from == B64 || from == ALF)
+        return 0;
+
+    /* A fixed-point word has no sign or point of its own, only hex digits, or
+     * binary ones */
+    if (from >= QFORMAT)
+        return check_base(num, (from - QFORMAT) / 32768 ? 2 : 16) || (memchr(num, '-', len) && fail(E_CODIFY)) ||
+               (memchr(num, '.', len) && fail(E_CODIFY));
+
+    for (size_t i = 0; i < len; i++) {
+        if (num[i] == '-')
+            sign = i;
+
+        else if (num[i] == '.')
+            decimal++;
+
+        else if (isdigit(num[i]) && isalpha(num[i]))
+            error++;
+    }
+
+    switch (error) {
+        /* No errors found */
+        case 0:
+            break;
+
+        /* There are errors */
+        default:
+            fail(E_CODIFY);
+            return 1;
+    }
+
+    switch (decimal) {
+        /* No decimal point */
         case 0:
             break;
 
-        /* There are errors */
+        /* Decimal point is present */
+        case 1: {
+            for (unsigned i = 0; i < (sizeof(code) / sizeof(struct codify)); i++)
+                if (from == code[i].id)
+                    if (!code[i].decimal) {
+                        fail(E_INTEGER, code[i].name[0]);
+                        return 1;
+                    }
+            break;
+        }
+
+        /* Multiple points are present */
+        default :
+            fail(E_CODIFY);
+            return 1;
+    }
+
+    switch (sign) {
+        /* No minus */
+        case -1:
+            break;
+
+        /* Minus is present */
+        case 0: {
+            for (unsigned i = 0; i < (sizeof(code) / sizeof(struct codify)); i++)
+                if (from == code[i].id)
+                    if (!code[i].signf) {
+                        fail(E_POSITIVE, code[i].name[0]);
+                        return 1;
+                    }
+
+            break;
+        }
+
+        /* Multiple minus are present */
+        default:
+            fail(E_CODIFY);
+            return 1;
+    }
+
+    /* Check whether the number is correct for the indicated base */
+    switch (from) {
+        case BIN:
+        case CO1:
+        case CO2:
+        case MES:
+
+            if (check_base(num, 2)) return 1;
+            break;
+
+        case DEC:
+
+            if (check_base(num, 10)) return 1;
+            break;
+
+        case BCD:
+        case ROM:
+
+            break;
+
+        default :
+
+            if (check_base(num, from - SCRAP)) return 1;
+    }
+
+    return 0;
+}
+
+/* FORMAT_SCAN - Checks that the format of the entered number respects the
+ * format required by the source codify (see codify_check() for the
+ * destination). Returns 1 on error, 0 otherwise.
+-----------------------------------------------------------------------------*/
+int format_scan(const char *num, unsigned from) {
+    size_t len = strlen(num);
+    int error;
+
+    TRACE(scan_entry, from, len);
+    error = format_check(num, len, from);
+    TRACE(scan_return, from, len, error ? failure : E_NONE);
+
+    return error;
+}
+
+/* FOLLOW_LINE - Converts a line of a followed file and writes its results, as
+ * batch mode does. Returns 1 on error, 0 otherwise.
+-----------------------------------------------------------------------------*/
+int follow_line(const struct request *req, char *num) {
+    struct output out = {NULL, 0, 0};
+    int error = 0;
+
+    if (!*num && !req->json)
+        fputc('\n', stdout);
+
+    else {
+        error = convert_number(req, num, &out);
+        fwrite(out.str, 1, out.len, stdout);
+    }
+
+    arena_reset(&scratch);
+
+    return error;
+}
+
+/* FOLLOW_MODE - Converts the lines of the file 'name', then those appended to
+ * it, until a signal stops the job (as «tail -F» does). inotify tells when the
+ * directory of the file changes, and only the new bytes are read: a line is
+ * converted once its newline is written. When another file takes the name
+ * (a rotation) the old one, already read to its end, is left for the new one,
+ * read from its start; a file that becomes shorter (truncated) is read again
+ * from its start. The results are written as soon as the input has been read
+ * to its end, and at least every FOLLOW milliseconds while it has not.
+ * Returns 1 on error.
+-----------------------------------------------------------------------------*/
+int follow_mode(const struct request *req, const char *name) {
+    static char buf[BLOCK], events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    struct sigaction sa = {.sa_handler = ring_stop};
+    struct timespec last, now;
+    struct stat st, cur;
+    char *part = NULL, *dir = strdup(name), *slash;
+    size_t plen = 0, psize = 0;
+    int fd = open(name, O_RDONLY), in = -1, error = 0;
+    off_t off = 0;
+
+    if (fd < 0 || fstat(fd, &cur) || !dir) {
+        perror(name);
+        free(dir);
+        return 1;
+    }
+
+    /* The directory is watched, rather than the file, so that a file that
+     * takes the name is noticed too. Without inotify the file is polled */
+    if ((slash = strrchr(dir, '/')))
+        slash[slash == dir] = '\0';    /* "/name" is in "/" */
+
+    if ((in = inotify_init1(IN_CLOEXEC | IN_NONBLOCK)) >= 0 &&
+        inotify_add_watch(in, slash ? dir : ".", IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) < 0) {
+        close(in);
+        in = -1;
+    }
+
+    free(dir);
+
+    /* Without SA_RESTART a signal also ends the wait for a change */
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &last);
+
+    while (!halt) {
+        ssize_t n = read(fd, buf, sizeof buf);
+
+        if (n > 0) {
+            off += n;
+
+            for (size_t start = 0, end; start < (size_t) n; start = end + 1) {
+                char *nl = memchr(buf + start, '\n', n - start);
+
+                end = nl ? (size_t) (nl - buf) : (size_t) n;
+
+                /* A line begun in an earlier block is completed in 'part' */
+                if (plen || !nl) {
+                    if (plen + end - start >= psize) {
+                        char *tmp = realloc(part, psize = 2 * (plen + end - start) + 64);
+
+                        if (!tmp) {
+                            fprintf(stderr, "Memory allocation error.\n");
+                            free(part);
+                            close(fd);
+                            return 1;
+                        }
+
+                        part = tmp;
+                    }
+
+                    memcpy(part + plen, buf + start, end - start);
+                    part[plen += end - start] = '\0';
+                }
+
+                if (nl && plen) {
+                    error |= follow_line(req, part);
+                    plen = 0;
+
+                } else if (nl) {
+                    *nl = '\0';
+                    error |= follow_line(req, buf + start);
+                }
+            }
+
+            clock_gettime(CLOCK_MONOTONIC, &now);
+
+            if ((now.tv_sec - last.tv_sec) * 1000 + (now.tv_nsec - last.tv_nsec) / 1000000 >= FOLLOW) {
+                fflush(stdout);
+                last = now;
+            }
+
+            continue;
+        }
+
+        if (n < 0 && errno != EINTR) {
+            perror(name);
+            error = 1;
+            break;
+        }
+
+        /* The input has been read to its end: the results are written */
+        fflush(stdout);
+        clock_gettime(CLOCK_MONOTONIC, &last);
+
+        if (!fstat(fd, &cur) && cur.st_size < off) {
+            fprintf(stderr, "%s: file truncated\n", name);
+            lseek(fd, 0, SEEK_SET);
+            off = 0;
+            plen = 0;
+            continue;
+        }
+
+        if (!stat(name, &st) && (st.st_ino != cur.st_ino || st.st_dev != cur.st_dev)) {
+            int next = open(name, O_RDONLY);
+
+            if (next >= 0) {
+                /* The last line of the old file may have no newline */
+                if (plen)
+                    error |= follow_line(req, part);
+
+                close(fd);
+                fd = next;
+                off = 0;
+                plen = 0;
+                continue;
+            }
+        }
+
+        /* The events only wake the job: the file is read again whatever they
+         * are */
+        if (in >= 0 && poll(&(struct pollfd) {.fd = in, .events = POLLIN}, 1, FOLLOW) > 0)
+            while (read(in, events, sizeof events) > 0);
+
+        else if (in < 0)
+            nanosleep(&(struct timespec) {0, FOLLOW * 1000000L}, NULL);
+    }
+
+    fflush(stdout);
+    free(part);
+    close(fd);
+
+    if (in >= 0)
+        close(in);
+
+    return error;
+}
+
+/* JSON_RECORD - Writes the result of the destination 'i' of the number 'input'
+ * as a line of JSON: {"input":...,"from":...,"to":...,"output":...,"bit":...,
+ * "error":...}. 'v' is the number read, or NULL if it could not be read: then
+ * 'failure' tells why. The output is null on error, and the error is one of
+ * the codes of enum errors (0 if there is none). Returns 1 on error.
+-----------------------------------------------------------------------------*/
+int json_record(const struct request *req, unsigned i, const char *input, const struct value *v, struct output *out) {
+    int done = 0;
+
+    out_puts(out, "{\"input\":");
+    json_string(out, input);
+    out_puts(out, ",\"from\":");
+    json_string(out, req->source);
+    out_puts(out, ",\"to\":");
+    json_string(out, req->name[i]);
+    out_puts(out, ",\"output\":");
+
+    if (v) {
+        size_t mark = out->len;
+
+        failure = E_NONE;
+
+        if (!out_puts(out, "\"") || codify_check(req->to[i], v) || !conversion_to(req->to[i], v, req->digits, req->bit, out)) {
+            if (out->str)
+                out->str[out->len = mark] = '\0';
+
+        } else
+            done = out_puts(out, "\"") != NULL;
+    }
+
+    /* An error without its own code is a number that cannot be written */
+    if (!done) {
+        out_puts(out, "null");
+
+        if (!failure)
+            failure = E_CODIFY;
+    }
+
+    out_puts(out, ",\"bit\":");
+    json_number(out, req->bit);
+    out_puts(out, ",\"error\":");
+    json_number(out, failure);
+    out_puts(out, "}\n");
+
+    return !done;
+}
+
+/* OPTARG_DEFINE - Defines the type of conversion.
+-----------------------------------------------------------------------------*/
+int optarg_define(const char *type) {
+    /* BCD */
+    for (unsigned i = 0; i < (sizeof code[BCD].name / sizeof code[BCD].name[0]); i++)
+        if (!strcmp(type, code[BCD].name[i]))
+            return BCD;
+
+    /* Binary */
+    for (unsigned i = 0; i < (sizeof code[BIN].name / sizeof code[BIN].name[0]); i++)
+        if (!strcmp(type, code[BIN].name[i]))
+            return BIN;
+
+    /* Ones' Complement */
+    for (unsigned i = 0; i < (sizeof code[CO1].name / sizeof code[CO1].name[0]); i++)
+        if (!strcmp(type, code[CO1].name[i]))
+            return CO1;
+
+    /* Two's complement */
+    for (unsigned i = 0; i < (sizeof code[CO2].name / sizeof code[CO2].name[0]); i++)
+        if (!strcmp(type, code[CO2].name[i]))
+            return CO2;
+
+    /* Decimal */
+    for (unsigned i = 0; i < (sizeof code[DEC].name / sizeof code[DEC].name[0]); i++)
+        if (!strcmp(type, code[DEC].name[i]))
+            return DEC;
+
+    /* Floating Point */
+    for (unsigned i = 0; i < (sizeof code[FLT].name / sizeof code[FLT].name[0]); i++)
+        if (!strcmp(type, code[FLT].name[i]))
+            return FLT;
+
+    /* Hexadecimal */
+    for (unsigned i = 0; i < (sizeof code[HEX].name / sizeof code[HEX].name[0]); i++)
+        if (!strcmp(type, code[HEX].name[i]))
+            return SCRAP + 16;
+
+    /* Signed Magnitude Representation */
+    for (unsigned i = 0; i < (sizeof code[MES].name / sizeof code[MES].name[0]); i++)
+        if (!strcmp(type, code[MES].name[i]))
+            return MES;
+
+    /* Roman */
+    for (unsigned i = 0; i < (sizeof code[ROM].name / sizeof code[ROM].name[0]); i++)
+        if (!strcmp(type, code[ROM].name[i]))
+            return ROM;
+
+    /* Octal */
+    for (unsigned i = 0; i < (sizeof code[OCT].name / sizeof code[OCT].name[0]); i++)
+        if (!strcmp(type, code[OCT].name[i]))
+            return SCRAP + 8;
+
+    /* Base32, Base58, Base64 and the custom alphabet, whose names are not
+     * those of base X: "base32" is the radix 32 */
+    for (unsigned id = B32; id <= ALF; id++)
+        for (unsigned i = 0; i < (sizeof code[id].name / sizeof code[id].name[0]); i++)
+            if (!strcmp(type, code[id].name[i]))
+                return id;
+
+    /* Fixed-point words: [u]qM.N, or [u]qN with the least integer bits, and a
+     * final 'b' when they are written in binary */
+    if (toupper(type[0]) == 'Q' || (toupper(type[0]) == 'U' && toupper(type[1]) == 'Q')) {
+        unsigned uns = toupper(type[0]) == 'U', binary;
+        const char *p = type + uns + 1;
+        unsigned long m, n;
+        char *end;
+
+        if (!isdigit(*p))
+            return 0;
+
+        m = strtoul(p, &end, 10);
+
+        if (*end == '.' && isdigit(end[1]))
+            n = strtoul(end + 1, &end, 10);
+        else
+            n = m, m = !uns;
+
+        binary = toupper(*end) == 'B';
+
+        if (end[binary] || m > 64 || n > 64 || m + n == 0 || m + n > 64 || (!uns && !m))
+            return 0;
+
+        return QFORMAT + 16384 * (2 * binary + uns) + 128 * m + n;
+    }
+
+    /* Base X */
+    if (!strncmp(type, "base", 4) || !strncmp(type, "BASE", 4)) {
+        int base = atoi(strrchr(type, 'e') + 1);
+
+        if (base > 0 && base < 37)
+            return SCRAP + base;
+
+        return SCRAP;
+    }
+
+    /* Base given by the prefix of each number */
+    if (!strcmp(type, "auto") || !strcmp(type, "AUTO"))
+        return AUTO;
+
+    return 0;
+}
+
+/* PRINT_HELP - Show help message.
+-----------------------------------------------------------------------------*/
+void print_help(const char *name) {
+    printf(
+            "%s\n"
+            "Radix and numerical codes converter\n\n"
+            "Usage: %s -f <CODIFY> -t <CODIFY> [NUMBER]\n\n"
+
+            "Options:\n\n"
+
+            " -f, --from            Source encoding\n"
+            " -t, --to              Destination encoding, or a list (e.g. hex,bin,co2)\n"
+            " -b  --bit             Number of bit/digit\n"
+            " -p, --precision       Number of fractional digits (default 20)\n"
+            " -s, --shortest        Shortest fraction that reads back as the number\n"
+            " -d, --delimiter       Write the results of a list on a line, separated\n"
+            "                       by this character (tab in batch mode)\n"
+            " -c, --column          Convert these columns (e.g. 3 or 2,5) of CSV\n"
+            "                       files, separated by -d (a comma by default)\n"
+            " -S, --stream          Convert a single number of any length between\n"
+            "                       bases 2, 4, 8, 16 and 32, or to and from base 1\n"
+            " -j, --json            Write a JSON object per line for each result, with\n"
+            "                       input, from, to, output, bit and error code\n"
+            " -R, --serve NAME      Convert the numbers sent by the clients of the\n"
+            "                       shared memory NAME (see shm_open()), until killed\n"
+            " -C, --client NAME     Send each line of the standard input to the server\n"
+            "                       NAME and write its results\n"
+            " -B, --bench CALLS     With -C, send the lines CALLS times and write the\n"
+            "                       times of the round trips instead\n"
+            " -r, --range START:END[:STEP]\n"
+            "                       Convert the integers from START to END (written\n"
+            "                       in the source codify), a line for each\n"
+            " -F, --follow FILE     Convert the lines of FILE, then those appended to\n"
+            "                       it, also after a rotation, until killed\n"
+            " -a, --alphabet SYMBOLS\n"
+            "                       Symbols of the digits of ALPHA, from 0: their\n"
+            "                       number (up to 256) is the radix\n"
+            " -X, --sweep WIDTH     Check that every integer of WIDTH bits (up to 32)\n"
+            "                       converts exactly between each pair of codifies\n"
+            "                       of -f and -t (by default the main ones), using\n"
+            "                       all processors, and write the mismatches\n"
+            " -T, --tables DIR      Keep the tables of the results of the integers of\n"
+            "                       16 bits in files of DIR, for the next runs\n"
+            " -Q, --round MODE      Rounding of the fixed-point words: nearest (ties\n"
+            "                       to even, the default) or truncate (toward -inf)\n"
+            " -h, --help            Show this help message and exit\n"
+            " -v, --version         Show version and exit\n\n"
+
+            "Codifies:\n\n"
+
+            " BASEX                 Generic Base, from 1 to 36 (BASE32 is positional,\n"
+            "                       unlike the B32 codec)\n"
+            " BCD                   Binary Coded Decimal\n"
+            " BIN                   Binary Base\n"
+            " CO1                   Ones' Complement\n"
+            " CO2                   Two's Complement\n"
+            " DEC                   Decimal Base\n"
+            " HEX                   Hexadecimal Base\n"
+            " MES                   Signed Magnitude Representation\n"
+            " OCT                   Octal Base\n"
+            " ROM                   Roman Numerals\n"
+            " B32                   RFC 4648 Base32 of the bytes of a natural number\n"
+            " B58                   Base58 (Bitcoin alphabet)\n"
+            " B64                   RFC 4648 Base64 of the bytes of a natural number\n"
+            " ALPHA                 Symbols given by -a\n"
+            " QM.N, UQM.N           Fixed-point word of M integer bits (with the sign\n"
+            "                       for Q) and N fractional ones, written in hex, or\n"
+            "                       in binary with a final B (e.g. q1.15, uq8.8b);\n"
+            "                       QN is Q1.N and UQN is UQ0.N\n"
+            " AUTO                  Source only: base 16, 2 or 8 for numbers written\n"
+            "                       with the prefix 0x, 0b or 0o, 10 otherwise\n\n"
+
+            "Examples:\n"
+            " %s -f dec -t bin 18.05          It converts from base 10 to base 2\n"
+            " %s -f bin -t base15 1010011010  It converts from base 2 to base 15\n"
+            " %s -f dec -t hex,bin,co2 -- -18  It converts from base 10 to all three\n\n"
+
+            "To enter a negative number type: -- <NUMBER>\n"
+            "For example, to enter the number -5 type: -- -5\n\n"
+
+            "Without NUMBER, a number per line is read from the standard input\n"
+            "and the results are written one per line (an empty line on error).\n"
+            "Without -f and -t, each line names its codifies: FROM TO NUMBER,\n"
+            "as in «hex dec,bin FF».\n"
+            "With -c and -S, the operands are the files to convert (by default\n"
+            "the standard input). From a pipe, -S converts only between bases\n"
+            "where each source digit gives whole digits (e.g. hex to bin).\n"
+            "The blanks around a number, the separators of its digits (as in\n"
+            "«1 000 000», «0xDEAD_BEEF» or «0b1010'0110»; blanks only before\n"
+            "groups of three) and the prefix of its base are ignored.\n\n"
+
+            "Error codes of the JSON output:\n"
+            " 0 none, 1 invalid number, 2 digit out of base, 3 integer only,\n"
+            " 4 positive only, 5 natural only, 6 too large, 7 invalid BCD,\n"
+            " 8 unary too long, 9 too few bit, 10 out of memory, 11 too long for a ring,\n"
+            " 12 invalid codify in a line, 13 saturated word (written anyway)\n\n"
+
+            "Report bugs to <norisgit@gmail.com>\n"
+
+            , VERSION, name, name, name, name);
+}
+
+
+/* RANGE_MODE - Converts the integers of 'range', START:END[:STEP] in the
+ * source codify, and writes a line of results for each one, as batch mode
+ * does. Only the first number is converted: the results of the next ones are
+ * made by adding the step to their digits (see counter_add()), unless the
+ * codify has no incremental form, the number is negative or the digits do
+ * not fit, which are converted as a whole. The numbers are taken RUN at a
+ * time: in a run that starts negative, the results in base X (binary and
+ * decimal included) are all written at once by ints_to_rad(). Returns 1 on
+ * error.
+-----------------------------------------------------------------------------*/
+int range_mode(const struct request *req, char *range) {
+    static struct counter c[TARGETS];
+    static size_t off[TARGETS][RUN + 1];
+    struct output run[TARGETS];
+    long long x[3] = {0, 0, 1};
+    uint64_t num[RUN];
+    unsigned k = 0, count;
+    int error = 0;
+
+    for (char *part = range, *next; part && k < 3; part = next, k++) {
+        unsigned from = req->from;
+        struct value v;
+        size_t n;
+
+        if ((next = strchr(part, ':')))
+            *next++ = '\0';
+
+        n = strlen(part);
+        part = token_clean(part, &n, &from);
+
+        if (format_scan(part, from) || conversion_from(from, part, &v))
+            return 1;
+
+        if (v.x != truncl(v.x) || fabsl(v.x) >= 0x1p63L) {
+            fprintf(stderr, "A range is made of integers of at most 63 bit.\n");
+            return 1;
+        }
+
+        x[k] = v.x;
+    }
+
+    if (k < 2 || x[2] <= 0 || x[0] > x[1]) {
+        fprintf(stderr, "Insert a range as START:END[:STEP], with START <= END and STEP > 0.\n");
+        return 1;
+    }
+
+    arena_reset(&scratch);
+
+    for (unsigned i = 0; i < req->count; i++)
+        counter_init(&c[i], req->to[i], req->bit, x[2]);
+
+    for (long long n = x[0];; n = num[count - 1] + x[2]) {
+        int last;
+
+        /* The numbers of the run, up to the end of the range */
+        for (num[0] = n, count = 1; count < RUN && x[1] - (long long) num[count - 1] >= x[2]; count++)
+            num[count] = num[count - 1] + x[2];
+
+        last = x[1] - (long long) num[count - 1] < x[2];
+
+        /* A column that cannot be written at once (a number without the bits
+         * of -b) is converted number by number, which tells the error */
+        for (unsigned i = 0; i < req->count; i++) {
+            run[i].str = NULL;
+            run[i].len = run[i].size = 0;
+
+            if (n < 0 && c[i].base && c[i].width == 1 && !c[i].lead) {
+                muted = 1;
+
+                if (!ints_to_rad(num, count, 1, c[i].base, req->bit, off[i], &run[i]))
+                    run[i].str = NULL;
+
+                muted = 0;
+            }
+        }
+
+        for (unsigned j = 0; j < count; j++) {
+            struct output line = {NULL, 0, 0};
+
+            for (unsigned i = 0; i < req->count; i++) {
+                const char *str;
+                size_t len;
+                char *p;
+
+                if (run[i].str) {
+                    str = run[i].str + off[i][j];
+                    len = off[i][j + 1] - off[i][j];
+                }
+
+                /* Digits that could not be incremented are converted again */
+                else {
+                    if (!c[i].live)
+                        error |= counter_set(&c[i], req, i, num[j]);
+
+                    str = c[i].str;
+                    len = c[i].len;
+                }
+
+                if ((p = out_reserve(&line, len + 1))) {
+                    memcpy(p, str, len);
+                    p[len] = i + 1 < req->count ? req->delimiter : '\n';
+                }
+            }
+
+            fwrite(line.str, 1, line.len, stdout);
+
+            for (unsigned i = 0; i < req->count; i++)
+                if (!run[i].str && c[i].live && (j + 1 < count || !last) && !counter_add(&c[i]))
+                    c[i].live = 0;
+        }
+
+        arena_reset(&scratch);
+
+        if (last)
+            break;
+    }
+
+    return error;
+}
+
+/* SERVE_MODE - Serves the conversions of 'req' to the clients of the ring
+ * 'name' (see struct ring) until a SIGINT or a SIGTERM, then removes the ring.
+ * The results of a number are the lines batch mode would write for it.
+ * Returns 1 on error.
+-----------------------------------------------------------------------------*/
+int serve_mode(const struct request *req, const char *name) {
+    struct sigaction sa = {.sa_handler = ring_stop};
+    struct ring *r = ring_open(name, 1);
+    static char num[CELL];
+
+    if (!r)
+        return 1;
+
+    /* No cell is held: the ticket that would hold each is RING behind */
+    for (unsigned i = 0; i < RING; i++) {
+        r->cell[i].seq = i;
+        r->cell[i].ticket = i - RING;
+    }
+
+    /* Without SA_RESTART a signal also ends the sleep on a futex */
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    __atomic_store_n(&r->server, getpid(), __ATOMIC_RELEASE);
+
+    for (;; r->head++) {
+        struct cell *c = &r->cell[r->head % RING];
+        struct output out = {NULL, 0, 0};
+        int error = 0, skip;
+
+        if ((skip = ring_wait(r, c, r->head + 1)) == 1)
+            break;
+
+        /* The client ended, or gave up, before sending its number */
+        if (skip)
+            continue;
+
+        memcpy(num, c->text, c->len);
+        num[c->len] = '\0';
+        failure = E_NONE;
+
+        if (!c->len && !req->json)
+            out_puts(&out, "\n");
+
+        else
+            error = convert_number(req, num, &out);
+
+        /* Results that do not fit are those of a number that cannot be read */
+        if (out.len >= CELL) {
+            error = fail(E_RING, CELL);
+            out.len = 0;
+            memcpy(num, c->text, c->len);
+
+            for (unsigned i = 0; i < req->count && req->json; i++)
+                json_record(req, i, num, NULL, &out);
+
+            if (!req->json || out.len >= CELL) {
+                out.len = 0;
+                out_puts(&out, "\n");
+            }
+        }
+
+        if ((c->len = out.len))
+            memcpy(c->text, out.str, out.len);
+
+        c->error = !error ? E_NONE : failure ? failure : E_CODIFY;
+        __atomic_store_n(&c->seq, r->head + 2, __ATOMIC_SEQ_CST);
+        ring_wake(c);
+        arena_reset(&scratch);
+    }
+
+    /* The clients waiting for an answer are told the server has stopped */
+    __atomic_store_n(&r->server, 0, __ATOMIC_SEQ_CST);
+
+    for (unsigned i = 0; i < RING; i++)
+        ring_wake(&r->cell[i]);
+
+    munmap(r, sizeof(struct ring));
+    shm_unlink(name);
+
+    return 0;
+}
+
+/* STREAM_MODE - Converts a single number of any length between two bases that
+ * are powers of two, reading it from 'fd' in blocks of BLOCK bytes and writing
+ * each digit as soon as its bits are known: only the bits of the digit being
+ * completed are kept, so the memory does not depend on the length.
+ * The first digit written takes the bits left over by the others, so the
+ * number of digits is looked up before reading them: a file gives its size,
+ * its first byte tells the sign and its last ones are read back to skip the
+ * final spaces and newlines. Any other input (e.g. a pipe) is read in a single
+ * pass, which is possible only when each source digit gives whole digits of
+ * the destination (as from base 16 to base 2): otherwise it is refused. A
+ * piped number ends at the first space or newline. Returns 1 on error, after
+ * writing the digits already converted.
+-----------------------------------------------------------------------------*/
+int stream_mode(const struct request *req, int fd) {
+    static char buf[BLOCK], out[BLOCK];
+    unsigned from = req->from == BIN ? 2 : req->from - SCRAP, to = req->to[0] == BIN ? 2 : req->to[0] - SCRAP;
+    unsigned a, b, bits = 0, need, lead = 1, sign = 0, piped = 0, tail = 0;
+    uint64_t acc = 0, digits = 0;
+    off_t start, end, n = 0;
+    size_t len = 0;
+    struct stat st;
+    ssize_t r = 0;
+    int error = 0;
+
+    /* Unary has a codec of its own */
+    if (req->count == 1 && from == 1)
+        return unary_count(req, fd);
+
+    if (req->count == 1 && to == 1)
+        return unary_write(req, fd);
+
+    if (req->count != 1 || from < 2 || from > 32 || from & (from - 1) || to < 2 || to > 32 || to & (to - 1)) {
+        fprintf(stderr, "Stream mode converts a number between bases 2, 4, 8, 16 and 32, or to and from base 1.\n");
+        return 1;
+    }
+
+    a = __builtin_ctz(from);
+    b = __builtin_ctz(to);
+
+    /* Only a file gives its size: the other inputs need no look ahead */
+    if (fstat(fd, &st) || !S_ISREG(st.st_mode) || (start = lseek(fd, 0, SEEK_CUR)) < 0) {
+        if (a % b) {
+            fprintf(stderr, "From a pipe, stream mode converts only to a base whose digits take whole digits of the "
+                            "source (e.g. from 16 to 2): write the number in a file.\n");
+            return 1;
+        }
+
+        piped = 1;
+        st.st_size = start = 0;
+    }
+
+    /* Look ahead: the spaces and newlines at the end are not digits */
+    for (end = st.st_size; end > start; end -= BLOCK) {
+        off_t at = end - start > BLOCK ? end - BLOCK : start;
+
+        if ((r = pread(fd, buf, end - at, at)) <= 0)
+            break;
+
+        while (r > 0 && isspace(buf[r - 1]))
+            r--;
+
+        if (r) {
+            end = at + r;
+            break;
+        }
+    }
+
+    if (end > start && pread(fd, buf, 1, start) == 1 && buf[0] == '-')
+        sign = 1;
+
+    if (!piped && ((n = end - start - sign) <= 0 || lseek(fd, start + sign, SEEK_SET) < 0)) {
+        fail(E_CODIFY);
+        return 1;
+    }
+
+    if (sign)
+        out[len++] = '-';
+
+    /* Bits of the first digit, the others have b bits each */
+    need = (n * a) % b ? (n * a) % b : b;
+
+    while (!error && (piped || n > 0) && (r = read(fd, buf, piped || n >= BLOCK ? BLOCK : n)) > 0) {
+        n -= r;
+
+        for (ssize_t i = 0; i < r; i++) {
+            unsigned d = isdigit(buf[i]) ? (unsigned) buf[i] - '0' :
+                         isalpha(buf[i]) ? (unsigned) toupper(buf[i]) - 'A' + 10 : from;
+
+            /* A piped number may start with a minus and end with blanks */
+            if (piped && !digits && !sign && !tail && buf[i] == '-') {
+                sign = 1;
+                out[len++] = '-';
+                continue;
+            }
+
+            if (piped && isspace(buf[i])) {
+                tail = 1;
+                continue;
+            }
+
+            if (tail) {
+                fail(E_CODIFY);
+                error = 1;
+                break;
+            }
+
+            if (d >= from) {
+                fail(E_BASE, from);
+                error = 1;
+                break;
+            }
+
+            acc = acc << a | d;
+            bits += a;
+            digits++;
+
+            while (bits >= need) {
+                d = acc >> (bits - need);
+                bits -= need;
+                acc &= ((uint64_t) 1 << bits) - 1;
+                need = b;
+
+                /* Leading zeros are not written */
+                if (lead && !d)
+                    continue;
+
+                lead = 0;
+                out[len++] = d < 10 ? d + '0' : d - 10 + 'A';
+
+                if (len == BLOCK) {
+                    fwrite(out, 1, len, stdout);
+                    len = 0;
+                }
+            }
+        }
+    }
+
+    if (r < 0) {
+        perror("read");
+        error = 1;
+    }
+
+    if (!error && piped && !digits) {
+        fail(E_CODIFY);
+        error = 1;
+    }
+
+    if (!error && lead)
+        out[len++] = '0';
+
+    fwrite(out, 1, len, stdout);
+    putchar('\n');
+
+    return error;
+}
+
+/* SWEEP_JOB - Checks the values of the lane 'arg' of a sweep, then those it
+ * steals from the others, until none is left.
+-----------------------------------------------------------------------------*/
+void *sweep_job(void *arg) {
+    struct lane *l = arg;
+    int64_t lo, hi;
+
+    while (sweep_take(l->sweep, l->self, &lo, &hi))
+        for (; lo < hi; lo++)
+            sweep_value(l, lo);
+
+    return NULL;
+}
+
+/* SWEEP_MODE - Checks every integer of 'width' bits, read both as a natural
+ * number and in two's complement (from -2^(width-1) to 2^width - 1): it must
+ * be written and read back exactly in each codify of the request (or, without
+ * codifies, in the fixed-width ones and the main bases), and its conversion
+ * from each codify to every other one must give what writing it there gives.
+ * A value that a codify cannot write (e.g. a negative one in BCD or in Roman
+ * numerals) is refused, with the pairs that need it. The values are
+ * shared among a thread for each processor, which steal them from each other
+ * (see struct sweep). Writes the first MISMATCHES mismatches, then the totals
+ * and the throughput. Returns 1 if there are mismatches or on error.
+-----------------------------------------------------------------------------*/
+int sweep_mode(const struct request *req, unsigned width) {
+    static const unsigned basic[] = {BIN, CO1, CO2, MES, BCD, DEC, SCRAP + 16, SCRAP + 8, ROM};
+    static const char *const names[] = {"bin", "c1", "c2", "ms", "bcd", "dec", "hex", "oct", "rom"};
+    int64_t lo = -((int64_t) 1 << (width - 1)), size = ((int64_t) 1 << width) - lo;
+    unsigned long long values = 0, trips = 0, refused = 0, mismatches = 0;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    struct sweep s = {.bit = req->bit};
+    struct timespec a, b;
+    double t;
+
+    if (req->count) {
+        s.id[s.count] = req->from;
+        s.name[s.count++] = req->source;
+
+        for (unsigned i = 0; i < req->count; i++) {
+            s.id[s.count] = req->to[i];
+            s.name[s.count++] = req->name[i];
+        }
+
+    } else
+        for (; s.count < sizeof basic / sizeof basic[0]; s.count++) {
+            s.id[s.count] = basic[s.count];
+            s.name[s.count] = names[s.count];
+        }
+
+    s.lanes = cpus > 0 ? cpus : 1;
+
+    if (!(s.lane = calloc(s.lanes, sizeof(struct lane)))) {
+        fprintf(stderr, "Memory allocation error.\n");
+        return 1;
+    }
+
+    pthread_mutex_init(&s.report, NULL);
+
+    for (unsigned i = 0; i < s.lanes; i++) {
+        pthread_mutex_init(&s.lane[i].lock, NULL);
+        s.lane[i].next = lo + size * i / s.lanes;
+        s.lane[i].end = lo + size * (i + 1) / s.lanes;
+        s.lane[i].self = i;
+        s.lane[i].sweep = &s;
+    }
+
+    /* The refused values are expected: their messages are not written */
+    quiet = 1;
+    clock_gettime(CLOCK_MONOTONIC, &a);
+
+    /* A lane whose thread cannot start is stolen by the others */
+    for (unsigned i = 1; i < s.lanes; i++)
+        s.lane[i].running = !pthread_create(&s.lane[i].thread, NULL, sweep_job, &s.lane[i]);
+
+    sweep_job(&s.lane[0]);
+
+    for (unsigned i = 1; i < s.lanes; i++)
+        if (s.lane[i].running)
+            pthread_join(s.lane[i].thread, NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    t = (b.tv_sec - a.tv_sec) + (b.tv_nsec - a.tv_nsec) / 1e9;
+
+    for (unsigned i = 0; i < s.lanes; i++) {
+        values += s.lane[i].values;
+        trips += s.lane[i].trips;
+        refused += s.lane[i].refused;
+        mismatches += s.lane[i].mismatches;
+        pthread_mutex_destroy(&s.lane[i].lock);
+    }
+
+    printf("%llu values of %u bit in %u codifies: %llu round trips in %.2f s (%.0f per second, %u threads)\n",
+           values, width, s.count, trips, t, t > 0 ? trips / t : 0, s.lanes);
+    printf("%llu refused, %llu mismatches\n", refused, mismatches);
+
+    pthread_mutex_destroy(&s.report);
+    free(s.lane);
+
+    return mismatches != 0;
+}
+
+/* SWEEP_TAKE - Gives to the thread of the lane 'self' of 's' the next values
+ * to check, from 'lo' to 'hi' (excluded), at most SWEEP. When its lane is
+ * empty, the back half of the largest lane left is moved to it first (all of
+ * it, if shorter than SWEEP). Only one lock is held at a time: the values
+ * being moved belong to no lane, but the thread moving them checks them.
+ * Returns 0 when no value is left.
+-----------------------------------------------------------------------------*/
+int sweep_take(struct sweep *s, unsigned self, int64_t *lo, int64_t *hi) {
+    struct lane *own = &s->lane[self];
+
+    for (;;) {
+        struct lane *victim = NULL;
+        int64_t most = 0, mid, end;
+
+        pthread_mutex_lock(&own->lock);
+
+        if (own->next < own->end) {
+            *lo = own->next;
+            *hi = own->end - own->next > SWEEP ? own->next + SWEEP : own->end;
+            own->next = *hi;
+            pthread_mutex_unlock(&own->lock);
+
+            return 1;
+        }
+
+        pthread_mutex_unlock(&own->lock);
+
+        for (unsigned i = 0; i < s->lanes; i++) {
+            pthread_mutex_lock(&s->lane[i].lock);
+
+            if (s->lane[i].end - s->lane[i].next > most) {
+                most = s->lane[i].end - s->lane[i].next;
+                victim = &s->lane[i];
+            }
+
+            pthread_mutex_unlock(&s->lane[i].lock);
+        }
+
+        if (!victim)
+            return 0;
+
+        pthread_mutex_lock(&victim->lock);
+        end = victim->end;
+        mid = end - victim->next > SWEEP ? victim->next + (end - victim->next) / 2 : victim->next;
+        victim->end = mid;
+        pthread_mutex_unlock(&victim->lock);
+
+        pthread_mutex_lock(&own->lock);
+        own->next = mid;
+        own->end = end;
+        pthread_mutex_unlock(&own->lock);
+    }
+}
+
+/* SWEEP_VALUE - Checks the value x in the codifies of the sweep of the lane
+ * 'l' (see sweep_mode()) and adds the results to its counters. The value is
+ * written in each codify without the tables (see table_get()), so that the
+ * conversions between codifies, which use them, check them too. The results
+ * are kept in the arena, which is emptied at the end.
+-----------------------------------------------------------------------------*/
+void sweep_value(struct lane *l, int64_t x) {
+    struct sweep *s = l->sweep;
+    struct value v, back[TARGETS + 1];
+    struct output enc[TARGETS + 1];
+    unsigned ok[TARGETS + 1];
+
+    value_set(&v, x);
+
+    /* Written in each codify and read back */
+    for (unsigned i = 0; i < s->count; i++) {
+        enc[i] = (struct output) {NULL, 0, 0};
+        ok[i] = !codify_check(s->id[i], &v) && conversion_write(s->id[i], &v, 0, s->bit, &enc[i]);
+
+        if (!ok[i]) {
+            l->refused++;
+            continue;
+        }
+
+        l->trips++;
+
+        if (format_scan(enc[i].str, s->id[i]) || conversion_from(s->id[i], enc[i].str, &back[i]) ||
+            back[i].x != x) {
+            ok[i] = 0;
+            l->mismatches++;
+            pthread_mutex_lock(&s->report);
+
+            if (s->reported++ < MISMATCHES)
+                printf("%lld: %s %s does not read back\n", (long long) x, s->name[i], enc[i].str);
+
+            pthread_mutex_unlock(&s->report);
+        }
+    }
+
+    /* Converted from each codify to the others */
+    for (unsigned i = 0; i < s->count; i++)
+        for (unsigned j = 0; j < s->count; j++) {
+            struct output out = {NULL, 0, 0};
+
+            if (i == j || !ok[i] || !ok[j])
+                continue;
+
+            l->trips++;
+
+            if (codify_check(s->id[j], &back[i]) || !conversion_to(s->id[j], &back[i], 0, s->bit, &out) ||
+                strcmp(out.str, enc[j].str)) {
+                l->mismatches++;
+                pthread_mutex_lock(&s->report);
+
+                if (s->reported++ < MISMATCHES)
+                    printf("%lld: %s %s gives %s %s, not %s\n", (long long) x, s->name[i], enc[i].str, s->name[j],
+                           out.str ? out.str : "nothing", enc[j].str);
+
+                pthread_mutex_unlock(&s->report);
+            }
+        }
+
+    l->values++;
+    arena_reset(&scratch);
+}
+
+/* UNARY_COUNT - Reads a number in unary from 'fd' in stream mode and writes
+ * it in the destination codify. The digits are counted a block at a time (see
+ * unary_zeros()), so the number can be larger than the memory; only spaces
+ * and newlines can follow them. Returns 1 on error.
+-----------------------------------------------------------------------------*/
+int unary_count(const struct request *req, int fd) {
+    static char buf[BLOCK];
+    struct output out = {NULL, 0, 0};
+    struct value v;
+    uint64_t count = 0;
+    unsigned end = 0;
+    ssize_t n;
+
+    while ((n = read(fd, buf, BLOCK)) > 0) {
+        size_t zeros = unary_zeros(buf, n);
+
+        count += zeros;
+
+        if (zeros == (size_t) n && !end)
+            continue;
+
+        for (ssize_t i = 0; i < n; i++)
+            if (isspace(buf[i]))
+                end = 1;
+
+            else if (buf[i] != '0' || end) {
+                fail(E_BASE, 1);
+                return 1;
+            }
+    }
+
+    if (n < 0) {
+        perror("read");
+        return 1;
+    }
+
+    value_set(&v, count);
+
+    if (codify_check(req->to[0], &v) || !conversion_to(req->to[0], &v, req->digits, req->bit, &out))
+        return 1;
+
+    fwrite(out.str, 1, out.len, stdout);
+    putchar('\n');
+    arena_reset(&scratch);
+
+    return 0;
+}
+
+/* UNARY_WRITE - Reads a number from 'fd' in stream mode and writes it in
+ * unary, which can be larger than the memory: a block of zeros is made once
+ * and written again and again. When the output is a pipe, vmsplice() gives it
+ * the pages of the block instead of copying them (they are never changed).
+ * Returns 1 on error.
+-----------------------------------------------------------------------------*/
+int unary_write(const struct request *req, int fd) {
+    static char buf[BLOCK] __attribute__((aligned(4096)));
+    unsigned from = req->from;
+    struct stat st;
+    struct value v;
+    uint64_t count;
+    size_t len = 0;
+    char *num;
+    ssize_t n;
+    int pipe;
+
+    /* The number itself is short */
+    while (len < FIELD && (n = read(fd, buf + len, FIELD - len)) > 0)
+        len += n;
+
+    while (len && isspace(buf[len - 1]))
+        len--;
+
+    buf[len] = '\0';
+
+    if (len == FIELD) {
+        fail(E_CODIFY);
+        return 1;
+    }
+
+    num = token_clean(buf, &len, &from);
+
+    if (format_scan(num, from) || conversion_from(from, num, &v) || codify_check(req->to[0], &v))
+        return 1;
+
+    if (v.big.n || v.x >= 18446744073709551616.0L) {
+        fail(E_LARGE);
+        return 1;
+    }
+
+    count = v.x;
+    arena_reset(&scratch);
+    memset(buf, '0', BLOCK);
+    fflush(stdout);
+    pipe = !fstat(STDOUT_FILENO, &st) && S_ISFIFO(st.st_mode);
+
+    while (count) {
+        struct iovec iov = {buf, count < BLOCK ? count : BLOCK};
+
+        n = pipe ? vmsplice(STDOUT_FILENO, &iov, 1, 0) : write(STDOUT_FILENO, buf, iov.iov_len);
+
+        if (n > 0)
+            count -= n;
+
+        /* A pipe that does not take pages is written as any other file */
+        else if (n < 0 && pipe && errno != EINTR && errno != EAGAIN)
+            pipe = 0;
+
+        else if (n < 0 && errno != EINTR) {
+            perror("write");
+            return 1;
+        }
+    }
+
+    return write(STDOUT_FILENO, "\n", 1) != 1;
+}
+
+/*=============================================================================
+ * TO DECIMAL CONVERSION FUNCTIONS
+=============================================================================*/
+
+/* ALPHA_SCAN - Reads a natural number written with the symbols of 'a' (Base58
+ * or a custom alphabet) in 'v'. The digits are read k at a time in a limb,
+ * which is then added to the limbs read so far, multiplied by base^k: the
+ * time is proportional to the square of the length, as for the base X
+ * numbers of at most BIG_DIGITS digits. Returns 1 on error, 0 otherwise.
+-----------------------------------------------------------------------------*/
+int alpha_scan(const char *num, const struct alphabet *a, struct value *v) {
+    size_t len = strlen(num), n = 0;
+    uint64_t *d;
+
+    if (!a->base) {
+        fail(E_SPEC, "alpha");
+        return 1;
+    }
+
+    if (!len) {
+        fail(E_CODIFY);
+        return 1;
+    }
+
+    if (!(d = arena_alloc(&scratch, (len * log2(a->base) / 64 + 2) * sizeof(uint64_t)))) {
+        fail(E_MEMORY);
+        return 1;
+    }
+
+    /* The first group has the digits left over by the others */
+    for (size_t i = 0, k = (len - 1) % a->k + 1; i < len; i += k, k = a->k) {
+        uint64_t chunk = 0, power = 1, carry;
+
+        for (size_t j = i; j < i + k; j++) {
+            unsigned digit = a->digit[(unsigned char) num[j]];
+
+            if (digit == ALPHABET_NONE) {
+                fail(E_BASE, a->base);
+                return 1;
+            }
+
+            chunk = chunk * a->base + digit;
+            power *= a->base;
+        }
+
+        carry = chunk;
+
+        for (size_t j = 0; j < n; j++) {
+            unsigned __int128 t = (unsigned __int128) d[j] * power + carry;
+
+            d[j] = t;
+            carry = t >> 64;
+        }
+
+        if (carry)
+            d[n++] = carry;
+    }
+
+    value_big(v, d, n);
+
+    return 0;
+}
+
+/* BCD_TO_DEC - Converts a BCD-encoded number to a decimal number.
+ * Returns -1 in the event of an error (if the BCD encoding is incorrect).
+-----------------------------------------------------------------------------*/
+long double bcd_to_dec(const char *bcd) {
+    unsigned len = strlen(bcd);
+    long double dec = 0;
+
+    /* If any numbers are missing in the encoding, it returns an error: remember
+     * that BCD encoding provides four bits to represent each decimal digit. */
+    if (len % 4 != 0)
+        return -1;
+
+    /* The index i scans each bit of the number encoded in BCD. The index j defines
+     * the significance of the bits. Initially is set to 10^(len/4-1) which specifies
+     * whether the four bits being analysed correspond to units, tens, hundreds, etc.
+     * For example if the number encoded in BCD is 000100100011 (i.e. 123) then len=3
+     * and therefore j is initially set to j=10^(3-1)=100. In fact the most significant
+     * bit of 123 belongs to the hundreds. This value is then multiplied by the
+     * respective BCD encoding (via if). The cycle continues by dividing j by 10, so
+     * that the significance of the next four bits is correct. This is done until the
+     * bits are finished.
+     */
+    for (unsigned i = 0, j = powl(10, len / 4 - 1); i < len; i += 4, j /= 10) {
+        if (bcd[i] == '0' && bcd[i + 1] == '0' && bcd[i + 2] == '0' && bcd[i + 3] == '0')
+            continue;
+        else if (bcd[i] == '0' && bcd[i + 1] == '0' && bcd[i + 2] == '0' && bcd[i + 3] == '1')
+            dec += 1 * j;
+        else if (bcd[i] == '0' && bcd[i + 1] == '0' && bcd[i + 2] == '1' && bcd[i + 3] == '0')
+            dec += 2 * j;
+        else if (bcd[i] == '0' && bcd[i + 1] == '0' && bcd[i + 2] == '1' && bcd[i + 3] == '1')
+            dec += 3 * j;
+        else if (bcd[i] == '0' && bcd[i + 1] == '1' && bcd[i + 2] == '0' && bcd[i + 3] == '0')
+            dec += 4 * j;
+        else if (bcd[i] == '0' && bcd[i + 1] == '1' && bcd[i + 2] == '0' && bcd[i + 3] == '1')
+            dec += 5 * j;
+        else if (bcd[i] == '0' && bcd[i + 1] == '1' && bcd[i + 2] == '1' && bcd[i + 3] == '0')
+            dec += 6 * j;
+        else if (bcd[i] == '0' && bcd[i + 1] == '1' && bcd[i + 2] == '1' && bcd[i + 3] == '1')
+            dec += 7 * j;
+        else if (bcd[i] == '1' && bcd[i + 1] == '0' && bcd[i + 2] == '0' && bcd[i + 3] == '0')
+            dec += 8 * j;
+        else if (bcd[i] == '1' && bcd[i + 1] == '0' && bcd[i + 2] == '0' && bcd[i + 3] == '1')
+            dec += 9 * j;
+        else
+            return -1;
+    }
+
+    return dec;
+}
+
+/* BYTES_SCAN - Reads in 'v' the natural number whose bytes, most significant
+ * first, are encoded by 'num' as RFC 4648 Base32 (bits = 5) or Base64 (bits =
+ * 6), with or without the padding. The symbols are decoded 16 at a time by
+ * group_decode(). Returns 1 on error, 0 otherwise.
+-----------------------------------------------------------------------------*/
+int bytes_scan(const char *num, unsigned bits, struct value *v) {
+    unsigned group = bits == 6 ? 12 : 10, rest;
+    size_t len = strlen(num), n, i = 0, skip = 0;
+    unsigned char *b;
+    uint64_t *d;
+
+    while (len && num[len - 1] == '=')
+        len--;
+
+    /* A last group must have a whole byte, and no bits for a byte it has not */
+    rest = len * bits % 8;
+    n = len * bits / 8;
+
+    if (!n || rest >= bits) {
+        fail(E_CODIFY);
+        return 1;
+    }
+
+    if (!(b = arena_alloc(&scratch, n + group)) || !(d = arena_alloc(&scratch, (n / 8 + 1) * sizeof(uint64_t)))) {
+        fail(E_MEMORY);
+        return 1;
+    }
+
+    for (; i + 16 <= len; i += 16)
+        if (group_decode(num + i, bits, b + i / 16 * group)) {
+            fail(E_BASE, 1u << bits);
+            return 1;
+        }
+
+    /* The last symbols are completed with zeros ('A') */
+    if (i < len) {
+        char last[16];
+
+        memset(last, 'A', sizeof last);
+        memcpy(last, num + i, len - i);
+
+        if (group_decode(last, bits, b + i / 16 * group)) {
+            fail(E_BASE, 1u << bits);
+            return 1;
+        }
+    }
+
+    while (skip + 1 < n && !b[skip])
+        skip++;
+
+    /* The limbs, the least significant first, from the bytes */
+    for (size_t j = 0; j < (n - skip + 7) / 8; j++) {
+        d[j] = 0;
+
+        for (size_t k = n - 8 * j - (n - 8 * j - skip >= 8 ? 8 : n - 8 * j - skip); k < n - 8 * j; k++)
+            d[j] = d[j] << 8 | b[k];
+    }
+
+    value_big(v, d, b[skip] ? (n - skip + 7) / 8 : 0);
+
+    return 0;
+}
+
+/* C1_TO_DEC - Converts a binary ones' complement number to decimal.
+ * It doesn't check if the passed number is actually binary: you must therefore
+ * perform this check before calling the function.
+-----------------------------------------------------------------------------*/
+long double co1_to_dec(const char *c1) {
+    /* If the number starts with 1 then is negative */
+    if (c1[0] == '1')
+
+        /* I perform the ones' complement of the number then
+         * I convert from binary to decimal, and I put the
+         * minus sign because it is negative */
+        return rad_to_dec(c1_converter(c1), 2) * -1;
+
+    /* If the number starts with 0 then this is positive,
+     * and I simply convert it from binary to decimal */
+    return rad_to_dec(c1, 2);
+}
+
+/* C2_TO_DEC - Converts a binary two's complement number to decimal.
+Needs a function that converts from binary to ones' complement. It does not
+check that the number passed is actually binary: you must therefore perform
+this check before calling the function.
+-----------------------------------------------------------------------------*/
+long double co2_to_dec(const char *c2) {
+    /* If the number starts with 1 then is negative */
+    if (c2[0] == '1')
+        return co1_to_dec(c2) - 1;
+
+    /* If the number starts with 0 then this is positive,
+     * and I simply convert it from binary to decimal */
+    return rad_to_dec(c2, 2);
+}
+
+/* MES_TO_DEC - Converts signed magnitude representation binary number into a
+ * decimal number. It does not check that the number passed is binary: you must
+ * therefore perform this action before calling the function.
+-----------------------------------------------------------------------------*/
+long double mes_to_dec(const char *ms) {
+    char *m = arena_alloc(&scratch, strlen(ms) + 1);
+
+    if (!m) {
+        fail(E_MEMORY);
+        return -1;
+    }
+
+    strcpy(m, ms);
+
+    /* Set the first bit to 0 to perform
+     * a correct conversion to decimal */
+    m[0] = '0';
+
+    /* Convert the number to decimal */
+    long double dec = rad_to_dec(m, 2);
+
+    /* If the first digit of the number in SMR is 1 then
+     * the number is negative (I multiply it by -1) */
+    if (ms[0] == '1')
+        return dec * -1;
+
+    /* If the first digit is 0 then the number is
+     * positive, and I return it without changing it */
+    return dec;
+}
+
+/* Q_SCAN - Reads the word 'num' of the fixed-point codify 'id' (see QFORMAT)
+ * into 'v': it is the value times 2^N, in two's complement for Q and as a
+ * natural number for UQ. The N fractional bits are kept as base 2 digits, so
+ * the value is exact. Returns 1 on error, 0 otherwise.
+-----------------------------------------------------------------------------*/
+int q_scan(const char *num, unsigned id, struct value *v) {
+    unsigned spec = id - QFORMAT, n = spec % 128, bits = n + spec / 128 % 128;
+    unsigned uns = spec / 16384 % 2, shift = spec / 32768 ? 1 : 4;
+    uint64_t word = 0, mask = bits == 64 ? UINT64_MAX : ((uint64_t) 1 << bits) - 1, mag, frac;
+    unsigned neg;
+
+    while (*num == '0')
+        num++;
+
+    if (strlen(num) * shift > 64) {
+        fail(E_LARGE);
+        return 1;
+    }
+
+    for (; *num; num++)
+        word = word << shift | (isdigit(*num) ? *num - '0' : toupper(*num) - 'A' + 10);
+
+    if (word & ~mask) {
+        fail(E_LARGE);
+        return 1;
+    }
+
+    neg = !uns && word >> (bits - 1) & 1;
+    mag = neg ? -word & mask : word;
+    frac = n == 64 ? mag : mag & (((uint64_t) 1 << n) - 1);
+
+    v->x = neg ? -ldexpl(mag, -n) : ldexpl(mag, -n);
+    v->sign = neg;
+    v->whole = n == 64 ? 0 : mag >> n;
+    v->frac.base = 2;
+    v->frac.len = frac ? n - __builtin_ctzll(frac) : 0;
+    v->frac.digit = NULL;
+
+    if (frac && !(v->frac.digit = arena_alloc(&scratch, v->frac.len))) {
+        fail(E_MEMORY);
+        return 1;
+    }
+
+    for (unsigned i = 0; i < v->frac.len; i++)
+        v->frac.digit[i] = frac >> (n - 1 - i) & 1;
+
+    return 0;
+}
+
+/* RAD_TO_BIG - Reads the n digits of an integer in base X as a big number,
+ * stored in the arena. The digits are split in halves by the powers of the
+ * base, so that the time is that of a few products of the whole size.
+-----------------------------------------------------------------------------*/
+void rad_to_big(const char *num, size_t n, unsigned base, struct big *x) {
+    int depth = big_depth();
+    struct power pw;
+    struct big t;
+
+    big_power(&pw, base, n, 0, depth);
+    t = big_read(num, n, &pw, depth);
+    big_power_free(&pw);
+
+    if (!(x->d = arena_alloc(&scratch, t.n * sizeof(uint64_t)))) {
+        fail(E_MEMORY);
+        x->n = 0;
+        free(t.d);
+        return;
+    }
+
+    memcpy(x->d, t.d, t.n * sizeof(uint64_t));
+    x->n = t.n;
+    free(t.d);
+}
+
+/* RAD_TO_DEC - Converts a number whatever base to decimal.
+-----------------------------------------------------------------------------*/
+long double rad_to_dec(const char *num, unsigned base) {
+    long double dec = 0;
+    unsigned sign = 0;
+
+    if (num[0] == '-') {
+        sign++;
+        num++;
+    }
+
+    /* Convert the integer part to base X */
+    for (; *num && *num != '.'; num++)
+        if (isdigit(*num))
+            dec = dec * base + (*num - '0');
+        else
+            dec = dec * base + (toupper(*num) - 'A' + 10);
+
+    /* Convert decimal part to decimal */
+    if (*num == '.') {
+        for (int j = 0; *++num;)
+            if (isdigit(*num))
+                dec += ((*num - '0') * powl(base, --j));
+            else
+                dec += ((toupper(*num) - 'A' + 10) * powl(base, --j));
+    }
+
+    if (sign)
+        return -1 * dec;
+
+    return dec;
+}
+
+/* ROM_TO_DEC - Converts from Roman numeration system to decimal.
+-----------------------------------------------------------------------------*/
+long double rom_to_dec(const char *rom) {
+    /* Assign a priority to each symbol, increasing in value, from 1 to 7: if
+     * the character has a lower priority than the one to its left I sum it up,
+     * otherwise I subtract it. This is cycled for each character of the string,
+     * starting with the rightmost (last) character. */
+
+    enum {
+        no, pi, pv, px, pl, pc, pd, pm
+    };
+    long double dec = 0;
+    unsigned priority = 0;
+
+    /* The word written for 0 (see dec_to_rom()) */
+    if (!strcasecmp(rom, "NULL"))
+        return 0;
+
+    for (unsigned i = strlen(rom); i > 0; i--)
+        switch (toupper(rom[i - 1])) {
+            case 'I':
+                if (priority <= pi)
+                    dec += 1;
+                else
+                    dec -= 1;
+
+                priority = pi;
+                break;
+
+            case 'V':
+                if (priority <= pv)
+                    dec += 5;
+                else
+                    dec -= 5;
+
+                priority = pv;
+                break;
+
+            case 'X':
+                if (priority <= px)
+                    dec += 10;
+                else
+                    dec -= 10;
+
+                priority = px;
+                break;
+
+            case 'L':
+                if (priority <= pl)
+                    dec += 50;
+                else
+                    dec -= 50;
+
+                priority = pl;
+                break;
+
+            case 'C':
+                if (priority <= pc)
+                    dec += 100;
+                else
+                    dec -= 100;
+
+                priority = pc;
+                break;
+
+            case 'D':
+                if (priority <= pd)
+                    dec += 500;
+                else
+                    dec -= 500;
+
+                priority = pd;
+                break;
+
+            case 'M':
+                if (priority <= pm)
+                    dec += 1000;
+                else
+                    dec -= 1000;
+
+                priority = pm;
+                break;
+
+            default :
+                fail(E_CODIFY);
+                return 0;
+        }
+
+    return dec;
+}
+
+
+/* VALUE_SCAN - Reads a number written in base X into 'v'. The integer part
+ * and the fractional digits are stored exactly, while 'x' gets the value of
+ * the whole number (correctly rounded by strtold() for decimal numbers).
+ * Integer parts that do not fit in 64 bits go to 'big' (see rad_to_big()).
+ * It doesn't check the digits: call check_base() before this function.
+-----------------------------------------------------------------------------*/
+void value_scan(const char *num, unsigned base, struct value *v) {
+    size_t len;
+
+    v->sign = num[0] == '-';
+    v->whole = 0;
+    len = strcspn(num + v->sign, ".");
+
+    /* Integer parts longer than 64 bits are read as big numbers: 'x' only
+     * gets their first digits */
+    if (len * log2(base) > 64) {
+        rad_to_big(num + v->sign, len, base, &v->big);
+        v->whole = big_value(v->big);
+        v->x = v->sign ? -v->whole : v->whole;
+        num += v->sign + len;
+    }
+
+    else {
+        v->x = base == 10 ? strtold(num, NULL) : rad_to_dec(num, base);
+
+        /* Integer part, exact as long as it fits in the mantissa */
+        for (num += v->sign; *num && *num != '.'; num++)
+            if (isdigit(*num))
+                v->whole = v->whole * base + (*num - '0');
+            else
+                v->whole = v->whole * base + (toupper(*num) - 'A' + 10);
+    }
+
+    if (*num == '.')
+        num++;
+
+    frac_scan(num, base, &v->frac);
+}
+
+/*=============================================================================
+FROM DECIMAL CONVERSION FUNCTIONS
+=============================================================================*/
+
+/* BIG_TO_RAD - Returns the digits of a big number in base X, stored in the
+ * arena, and their number in 'len'. The number is split in halves by the
+ * powers of the base, dividing by their reciprocals: the time is that of a few
+ * products of the whole size. The number of digits is not known before, so
+ * they are written with enough leading zeros, which are then skipped.
+-----------------------------------------------------------------------------*/
+const char *big_to_rad(struct big x, unsigned base, unsigned *len) {
+    int depth = big_depth();
+    size_t n = big_bits(x) * log(2) / log(base) + 2, i = 0;
+    struct power pw;
+    char *str;
+
+    if (!(str = arena_alloc(&scratch, n + 1))) {
+        fail(E_MEMORY);
+        return NULL;
+    }
+
+    big_power(&pw, base, n, 1, depth);
+    big_write(x, n, str, &pw, depth);
+    big_power_free(&pw);
+
+    while (i + 1 < n && str[i] == '0')
+        i++;
+
+    str[n] = '\0';
+    *len = n - i;
+
+    return str + i;
+}
+
+/* DEC_TO_BCD - Converts from decimal (positive integer) to BCD encoding.
+-----------------------------------------------------------------------------*/
+const char *dec_to_bcd(long double dec, unsigned bit, struct output *bcd) {
+    static const char nibble[10][4] = {
+            "0000", "0001", "0010", "0011", "0100", "0101", "0110", "0111", "1000", "1001"
+    };
+    unsigned len = 4 * rad_len(dec, 10), n = bit_number(len, bit);
+    char *p;
+
+    if (!n || !(p = out_reserve(bcd, n)))
+        return NULL;
+
+    /* Four bits for each decimal digit, from the right */
+    for (unsigned i = n; i > n - len; i -= 4) {
+        unsigned d = fmodl(dec, 10);
+
+        dec = (dec - d) / 10;
+        memcpy(p + i - 4, nibble[d], 4);
+    }
+
+    memset(p, '0', n - len);
+
+    return bcd->str;
+}
+
+/* DEC_TO_CO1 - Convert from decimal to ones' complement.
+-----------------------------------------------------------------------------*/
+const char *dec_to_co1(long double dec, unsigned bit, struct output *co1) {
+    long double num = fabsl(dec);
+    unsigned n = bit_number(rad_len(num, 2) + 1, bit);
+    char *p;
+
+    if (!n || !(p = out_reserve(co1, n)))
+        return NULL;
+
+    /* Write the binary number from the right, with a zero in front (the
+     * sign), and complement every bit if the number is negative */
+    for (unsigned i = n; i > 0; i--) {
+        unsigned b = fmodl(num, 2);
+
+        num = (num - b) / 2;
+        p[i - 1] = (b ^ (dec < 0)) + '0';
+    }
+
+    return co1->str;
+}
+
+/* DEC_TO_CO2 - Convert from decimal to two's complement.
+-----------------------------------------------------------------------------*/
+const char *dec_to_co2(long double dec, unsigned bit, struct output *co2) {
+    long double num = fabsl(dec);
+    unsigned n = bit_number(rad_len(num, 2) + 1, bit), carry = dec < 0;
+    char *p;
+
+    if (!n || !(p = out_reserve(co2, n)))
+        return NULL;
+
+    /* Same as the ones' complement, adding 1 while writing the bits when the
+     * number is negative */
+    for (unsigned i = n; i > 0; i--) {
+        unsigned b = fmodl(num, 2);
+
+        num = (num - b) / 2;
+        b = (b ^ (dec < 0)) + carry;
+        carry = b >> 1;
+        p[i - 1] = (b & 1) + '0';
+    }
+
+    return co2->str;
+}
+
+/* DEC_TO_FLT - Convert from decimal to floating point.
+-----------------------------------------------------------------------------*/
+const char *dec_to_flt(long double dec, struct output *flt) {
+    size_t start = flt->len;
+    char tmp[128], *p;
+
+    if (!(p = out_reserve(flt, 1)))
+        return NULL;
+
+    /* Save the sign of the number */
+    if (dec < 0) {
+        dec *= -1;
+        *p = '1';
+    } else
+        *p = '0';
+
+    snprintf(tmp, sizeof tmp, "%Lf", dec);
+
+    /* Save the exponent in two's complement */
+    unsigned len = strlen(tmp) - strlen(strchr(tmp, '.'));
+
+    if (!dec_to_co2(len, 0, flt) || !dec_to_rad(atof(remove_symbols(tmp)), 2, flt))
+        return NULL;
+
+    //return flt->str;
+    flt->len = start;
+
+    return out_puts(flt, "TODO");
+}
+
+/* DEC_TO_MES - Converts from signed magnitude representation to decimal.
+-----------------------------------------------------------------------------*/
+const char *dec_to_mes(long double dec, unsigned bit, struct output *mes) {
+    long double num = fabsl(dec);
+    unsigned n = bit_number(rad_len(num, 2) + 1, bit);
+    char *p;
+
+    if (!n || !(p = out_reserve(mes, n)))
+        return NULL;
+
+    /* Write the number in binary: if it is negative the first
+     * bit is 1, otherwise it is a zero */
+    for (unsigned i = n; i > 1; i--) {
+        unsigned b = fmodl(num, 2);
+
+        num = (num - b) / 2;
+        p[i - 1] = b + '0';
+    }
+
+    p[0] = dec < 0 ? '1' : '0';
+
+    return mes->str;
+}
+
+/* DEC_TO_RAD - Convert from decimal to base X.
+-----------------------------------------------------------------------------*/
+const char *dec_to_rad(long double num, unsigned base, struct output *out) {
+    struct value v;
+
+    value_set(&v, num);
+
+    return val_to_rad(&v, base, PRECISION, 0, out);
+}
+
+/* DEC_TO_ROM - Converts from decimal to Roman numeration system, from the
+ * largest symbol (or subtractive pair) down. There is no symbol above M, so
+ * the thousands are a row of M, at most UNARY as for a number in unary.
+-----------------------------------------------------------------------------*/
+const char *dec_to_rom(long double dec, struct output *rom) {
+    static const char *const symbol[] = {"M", "CM", "D", "CD", "C", "XC", "L", "XL", "X", "IX", "V", "IV", "I"};
+    static const unsigned value[] = {1000, 900, 500, 400, 100, 90, 50, 40, 10, 9, 5, 4, 1};
+    unsigned long long n;
+    char *p;
+
+    /* The equivalent of 0 is the latin word "nulla" */
+    if (dec == 0)
+        return out_puts(rom, "NULL");
+
+    if (dec / 1000 > UNARY) {
+        fail(E_LARGE);
+        return NULL;
+    }
+
+    /* The hundreds, tens and units take at most 12 symbols (DCCCLXXXVIII) */
+    n = dec;
+
+    if (!(p = out_reserve(rom, n / 1000 + 12)))
+        return NULL;
+
+    for (unsigned i = 0; i < sizeof value / sizeof value[0]; i++)
+        for (; n >= value[i]; n -= value[i]) {
+            memcpy(p, symbol[i], strlen(symbol[i]));
+            p += strlen(symbol[i]);
+        }
+
+    rom->len = p - rom->str;
+    rom->str[rom->len] = '\0';
+
+    return rom->str;
+}
+
+/* INTS_TO_RAD - Converts the n integers 'x' (of type int64_t if 'sign', else
+ * uint64_t) to base X, one after the other in 'out', each with 'bit' digits if
+ * given (0 for the least needed) after its minus. The number i is written from
+ * off[i] of out->str, and off[n] is where the last one ends: the offsets do
+ * not change when the output grows. The digits are written by u64_to_rad(),
+ * with vectors in bases 2 and 16. Returns out->str, or NULL on error (then
+ * nothing is written).
+-----------------------------------------------------------------------------*/
+const char *ints_to_rad(const uint64_t *x, size_t n, int sign, unsigned base, unsigned bit, size_t *off, struct output *out) {
+    size_t start = out->len;
+    char *p, digits[64];
+
+    /* Room for the longest numbers, given back at the end */
+    if (!(p = out_reserve(out, n * (1 + (bit > 64 ? bit : 64)))))
+        return NULL;
+
+    for (size_t i = 0; i < n; i++) {
+        int minus = sign && (int64_t) x[i] < 0;
+        unsigned len = u64_to_rad(minus ? -x[i] : x[i], base, digits + sizeof digits), w;
+
+        if (!(w = bit_number(len, bit))) {
+            out->str[out->len = start] = '\0';
+            return NULL;
+        }
+
+        off[i] = p - out->str;
+
+        if (minus)
+            *p++ = '-';
+
+        memset(p, '0', w - len);
+        memcpy(p + w - len, digits + sizeof digits - len, len);
+        p += w;
+    }
+
+    off[n] = p - out->str;
+    out->str[out->len = off[n]] = '\0';
+
+    return out->str;
+}
+
+/* VAL_TO_ALPHA - Writes a natural number with the symbols of 'a' (Base58 or
+ * a custom alphabet), with at least 'bit' digits. The limbs are divided by
+ * base^k, the largest power that fits in a limb, which gives k digits at a
+ * time: a division of the whole number is needed for every k digits.
+-----------------------------------------------------------------------------*/
+const char *val_to_alpha(const struct value *v, const struct alphabet *a, unsigned bit, struct output *out) {
+    size_t n = v->big.n, len = 0, max;
+    unsigned char *digit;
+    uint64_t *d;
+    unsigned m;
+    char *p;
+
+    if (!a->base) {
+        fail(E_SPEC, "alpha");
+        return NULL;
+    }
+
+    if (!n && v->whole >= 0x1p64L) {
+        fail(E_LARGE);
+        return NULL;
+    }
+
+    max = (n ? n : 1) * 64 / log2(a->base) + a->k + 1;
+
+    if (!(d = arena_alloc(&scratch, (n ? n : 1) * sizeof(uint64_t))) || !(digit = arena_alloc(&scratch, max))) {
+        fail(E_MEMORY);
+        return NULL;
+    }
+
+    if (n)
+        memcpy(d, v->big.d, n * sizeof(uint64_t));
+
+    else if ((d[0] = v->whole))
+        n = 1;
+
+    /* The digits, the least significant first */
+    while (n) {
+        uint64_t r = 0;
+
+        if (n == 1) {
+            r = d[0] % a->power;
+            d[0] /= a->power;
+        }
+
+        else
+            for (size_t i = n; i > 0; i--) {
+                unsigned __int128 t = (unsigned __int128) r << 64 | d[i - 1];
+
+                d[i - 1] = t / a->power;
+                r = t % a->power;
+            }
+
+        while (n && !d[n - 1])
+            n--;
+
+        for (unsigned j = 0; j < a->k; j++, r /= a->base)
+            digit[len++] = r % a->base;
+    }
+
+    while (len > 1 && !digit[len - 1])
+        len--;
+
+    if (!len)
+        digit[len++] = 0;
+
+    if (!(m = bit_number(len, bit)) || !(p = out_reserve(out, m)))
+        return NULL;
+
+    memset(p, a->sym[0], m - len);
+
+    for (size_t i = 0; i < len; i++)
+        p[m - 1 - i] = a->sym[digit[i]];
+
+    return out->str;
+}
+
+/* VAL_TO_BYTES - Writes the bytes of a natural number, most significant first,
+ * as RFC 4648 Base32 (bits = 5) or Base64 (bits = 6), with the padding. The
+ * bytes are encoded 10 or 12 at a time by group_encode().
+-----------------------------------------------------------------------------*/
+const char *val_to_bytes(const struct value *v, unsigned bits, struct output *out) {
+    unsigned group = bits == 6 ? 12 : 10, block = bits == 6 ? 3 : 5, chars = bits == 6 ? 4 : 8;
+    size_t n, len, size;
+    unsigned char *b;
+    char *p;
+
+    if (!(b = value_bytes(v, &n)))
+        return NULL;
+
+    len = (8 * n + bits - 1) / bits;
+    size = (n + block - 1) / block * chars;
+
+    /* The blocks read the zeros after the bytes, and write past the end */
+    if (!(p = out_reserve(out, (n + group - 1) / group * 16)))
+        return NULL;
+
+    for (size_t i = 0; i < n; i += group)
+        group_encode(b + i, bits, p + i / group * 16);
+
+    memset(p + len, '=', size - len);
+    out->len -= (n + group - 1) / group * 16 - size;
+    out->str[out->len] = '\0';
+
+    return out->str;
+}
+
+/* VAL_TO_Q - Writes a value as the word of the fixed-point codify 'id' (see
+ * QFORMAT): the value times 2^N, rounded as asked by option -Q, in two's
+ * complement for Q, with a digit for every 4 bits of the word (every bit in
+ * binary). Only integers are used, so the word is exact. A value out of the
+ * range of the word gives its nearest end, which is written anyway and
+ * reported as E_SATURATE.
+-----------------------------------------------------------------------------*/
+const char *val_to_q(const struct value *v, unsigned id, struct output *out) {
+    unsigned spec = id - QFORMAT, n = spec % 128, m = spec / 128 % 128, uns = spec / 16384 % 2;
+    unsigned binary = spec / 32768, bits = m + n, len = binary ? bits : (bits + 3) / 4;
+    unsigned __int128 q = 0, lim = (unsigned __int128) 1 << (bits - !uns), max;
+    int saturated = v->big.n || v->whole >= 0x1p64L, rest = 0;
+    uint64_t frac, word;
+    char buf[64], *p;
+
+    /* The magnitude of the value times 2^N, and what is left after it */
+    if (!saturated) {
+        q = (unsigned __int128) (uint64_t) v->whole << n;
+
+        if (v->frac.len) {
+            if ((rest = frac_to_bits(&v->frac, n, &frac)) < 0)
+                return NULL;
+
+            q |= frac;
+        }
+
+        /* Truncation is toward minus infinity: a negative value grows */
+        if (rounding == NEAREST ? rest == 3 || (rest == 2 && q & 1) : v->sign && rest)
+            q++;
+    }
+
+    /* A Q word holds magnitudes up to 2^(M+N-1) if negative, one less if not;
+     * an UQ word up to 2^(M+N) - 1, and no negative one */
+    max = v->sign ? (uns ? 0 : lim) : lim - 1;
+
+    if (saturated || q > max) {
+        q = max;
+        fail(E_SATURATE, uns ? "U" : "", m, n);
+    }
+
+    word = v->sign ? -(uint64_t) q : (uint64_t) q;
+
+    /* The digits of the whole word, with its leading zeros */
+    u64_to_rad(bits == 64 ? word : word & (((uint64_t) 1 << bits) - 1), binary ? 2 : 16, buf + sizeof buf);
+
+    if (!(p = out_reserve(out, len)))
+        return NULL;
+
+    memcpy(p, buf + sizeof buf - len, len);
+
+    return out->str;
+}
+
+/* VAL_TO_RAD - Convert a value to base X. The fractional part is converted
+ * from its exact digits by frac_to_rad(), so no error is accumulated: the
+ * 'digits' digits written are rounded to nearest, or 'digits' is SHORTEST.
+ * The integer part is written with 'bit' digits, if given; when it is a big
+ * number its digits are written by big_to_rad().
+-----------------------------------------------------------------------------*/
+const char *val_to_rad(const struct value *v, unsigned base, int digits, unsigned bit, struct output *out) {
+    long double num = v->whole;
+    const char *big = NULL;
+    unsigned len, n;
+    size_t start = out->len + v->sign;
+    int carry = 0;
+    char *p;
+
+    if (v->big.n && !(big = big_to_rad(v->big, base, &len)))
+        return NULL;
+
+    n = bit_number(big ? len : rad_len(num, base), bit);
+
+    if (!n || !(p = out_reserve(out, v->sign + n)))
+        return NULL;
+
+    /* If the number is negative I add a minus */
+    if (v->sign)
+        *p++ = '-';
+
+    /* A big integer part has already been written */
+    if (big) {
+        memset(p, '0', n - len);
+        memcpy(p + n - len, big, len);
+    }
+
+    /* An integer part of 64 bits is written by u64_to_rad() */
+    else if (num < 0x1p64L) {
+        char rad[64];
+
+        len = u64_to_rad(num, base, rad + sizeof rad);
+        memset(p, '0', n - len);
+        memcpy(p + n - len, rad + sizeof rad - len, len);
+    }
+
+    /* Convert the integer part from decimal to base X, dividing by base and
+     * saving the remainder, from the last digit to the first one */
+    else {
+        for (unsigned i = n; i > 0; i--) {
+            unsigned d = fmodl(num, base);
+
+            num = (num - d) / base;
+            p[i - 1] = d < 10 ? d + '0' : d - 10 + 'A';
+        }
+    }
+
+    /* Insert decimal point and the digits of the decimal part: the shortest
+     * ones are less than those needed to tell apart base^-len (of the source)
+     * from its half */
+    if (v->frac.len) {
+        size_t point = out->len;
+
+        len = digits != SHORTEST ? digits : ceil((v->frac.len * log(v->frac.base) + log(2)) / log(base)) + 1;
+
+        if (!(p = out_reserve(out, 1 + len)))
+            return NULL;
+
+        *p = '.';
+
+        if ((carry = frac_to_rad(&v->frac, base, digits, p + 1)) < 0)
+            return NULL;
+
+        /* No digits are left when rounding to an integer */
+        out->len = (len = strlen(p + 1)) ? point + 1 + len : point;
+        out->str[out->len] = '\0';
+
+        /* Rounded to an integer with a tie: the last digit must be even */
+        if (carry == 2) {
+            unsigned d = isdigit(out->str[point - 1]) ? out->str[point - 1] - '0' :
+                         out->str[point - 1] - 'A' + 10;
+            carry = d % 2;
+        }
+    }
+
+    /* The fraction was rounded up to 1: add it to the integer part, whose
+     * largest digits turn to 0 */
+    const char top = base - 1 < 10 ? base - 1 + '0' : base - 11 + 'A';
+
+    for (size_t i = start + n; carry && i > start; i--)
+        if (out->str[i - 1] == top)
+            out->str[i - 1] = '0';
+        else {
+            out->str[i - 1] = out->str[i - 1] == '9' ? 'A' : out->str[i - 1] + 1;
+            carry = 0;
+        }
+
+    if (carry) {
+        if (!out_reserve(out, 1))
+            return NULL;
+
+        memmove(out->str + start + 1, out->str + start, out->len - start - 1);
+        out->str[start] = '1';
+    }
+
+    return out->str;
+}
+
+/*=============================================================================
+ * AUXILIARY FUNCTIONS
+=============================================================================*/
+
+/* ALPHA_INIT - Makes 'a' the alphabet of the symbols 'sym', the first one for
+ * the digit 0. They must be at least 2, at most 256, different and not blank.
+ * Returns 1 on error, 0 otherwise.
+-----------------------------------------------------------------------------*/
+int alpha_init(struct alphabet *a, const char *sym) {
+    size_t base = strlen(sym);
+
+    for (unsigned i = 0; i < 256; i++)
+        a->digit[i] = ALPHABET_NONE;
+
+    if (base < 2 || base > 256)
+        return 1;
+
+    for (unsigned i = 0; i < base; i++) {
+        unsigned char c = sym[i];
+
+        if (isspace(c) || a->digit[c] != ALPHABET_NONE)
+            return 1;
+
+        a->digit[c] = i;
+    }
+
+    a->sym = sym;
+    a->base = base;
+    a->k = 0;
+    a->power = 1;
+
+    for (; a->power <= UINT64_MAX / base; a->k++)
+        a->power *= base;
+
+    return 0;
+}
+
+/* ARENA_ALLOC - Returns 'size' bytes from the arena, taking a new block from
+ * the heap only if none of the blocks already owned has room for them.
+-----------------------------------------------------------------------------*/
+void *arena_alloc(struct arena *a, size_t size) {
+    struct block *b = a->cur;
+
+    /* Keep every allocation aligned as malloc() would */
+    size = (size + sizeof(max_align_t) - 1) / sizeof(max_align_t) * sizeof(max_align_t);
+
+    if (b && b->size - b->used >= size) {
+        b->used += size;
+        return (char *) b->data + b->used - size;
+    }
+
+    /* The following blocks are still full of the data of an older conversion */
+    while (b && b->next) {
+        b = b->next;
+        b->used = 0;
+
+        if (b->size >= size) {
+            a->cur = b;
+            b->used = size;
+            return b->data;
+        }
+    }
+
+    struct block *n = malloc(sizeof(struct block) + (size > ARENA_BLOCK ? size : ARENA_BLOCK));
+
+    if (!n)
+        return NULL;
+
+    n->next = NULL;
+    n->size = size > ARENA_BLOCK ? size : ARENA_BLOCK;
+    n->used = size;
+
+    if (b)
+        b->next = n;
+    else
+        a->head = n;
+
+    a->cur = n;
+
+    return n->data;
+}
+
+/* ARENA_RESET - Frees all the memory taken from the arena, in constant time.
+-----------------------------------------------------------------------------*/
+void arena_reset(struct arena *a) {
+    if ((a->cur = a->head))
+        a->head->used = 0;
+}
+
+/* BIT_NUMBER - Returns the number of bits/digits to write for a number that
+ * needs 'len' of them: 'bit' if it was given, 'len' otherwise. Returns 0 if
+ * the number doesn't fit in 'bit' bits.
+-----------------------------------------------------------------------------*/
+unsigned bit_number(unsigned len, unsigned bit) {
+    if (bit == 0)
+        return len;
+
+    if (len > bit) {
+        fail(E_BIT, len);
+        return 0;
+    }
+
+    return bit;
+}
+
+/* C1_CONVERTER - Performs the ones' complement of the binary number entered.
+ * Doesn't check if the number is binary: you must therefore perform this
+ * check before calling the function.
+-----------------------------------------------------------------------------*/
+char *c1_converter(const char *bin) {
+    unsigned len = strlen(bin);
+    char *c1 = arena_alloc(&scratch, len + 1);
+
+    if (!c1) {
+        fail(E_MEMORY);
+        return NULL;
+    }
+
+    for (unsigned i = 0; i < len; i++)
+        c1[i] = bin[i] == '0' ? '1' : '0';
+
+    c1[len] = '\0';
+
+    return c1;
+}
+
+/* CHECK_BASE - Returns 0 if the passed string contains only the digits allowed
+ * for that particular base (e.g. 0,1,2,3,4,5,6,7 in octal base or 0 and 1 in
+ * binary base). Returns 1 if invalid values are contained.
+-----------------------------------------------------------------------------*/
+int check_base(const char *x, unsigned base) {
+    size_t count = 0, point = 0;
+
+    /* The minus in the first position is a valid character */
+    if (x[0] == '-')
+        count++;
+
+    /* Increase count at each valid character */
+    for (size_t i = 0, len = strlen(x); i < len; i++) {
+        /* The character is valid if it is correct for that base */
+        if (x[i] - '0' < base)
+            count++;
+
+        /* The letter must be correct for that particular base */
+        else if (toupper(x[i]) >= 'A' && toupper(x[i]) <= base + 'A' - 11)
+            count++;
+
+        /* Count the points present (there may be 0 or 1) */
+        else if (x[i] == '.') {
+            count++;
+            point++;
+        }
+    }
+
+    /* The string is correct if count is equal to the length of
+     * the string and if the number of decimal points is 0 or 1 */
+    if (count == strlen(x) && point < 2)
+        return 0;
+
+    fail(E_BASE, base);
+    return 1;
+}
+
+/* COUNTER_ADD - Adds the step to the digits of a counter, in place: only the
+ * digits reached by the step or by a carry are changed, so that an increment
+ * takes a constant time on average. Without a width given with -b, a base X
+ * number grows by a digit on the left when needed. Returns 0 if the result
+ * does not fit in the digits, which must be converted again.
+-----------------------------------------------------------------------------*/
+int counter_add(struct counter *c) {
+    unsigned carry = 0, k = 0;
+    size_t i = c->len;
+
+    for (; k < c->steps || carry; k++) {
+        unsigned d = carry + (k < c->steps ? c->step[k] : 0);
+
+        if (i < c->lead + c->width) {
+            /* A new digit on the left */
+            if (!c->grow || c->str == c->buf)
+                return 0;
+
+            *--c->str = '0';
+            c->len++;
+            i++;
+        }
+
+        i -= c->width;
+
+        /* The digit, written in base X or in binary for BCD */
+        if (c->width == 1)
+            d += c->str[i] <= '9' ? c->str[i] - '0' : c->str[i] - 'A' + 10;
+        else
+            for (unsigned b = 0; b < c->width; b++)
+                d += (c->str[i + b] - '0') << (c->width - 1 - b);
+
+        carry = d >= c->base;
+        d -= carry * c->base;
+
+        if (c->width == 1)
+            c->str[i] = d < 10 ? '0' + d : 'A' + d - 10;
+        else
+            for (unsigned b = 0; b < c->width; b++)
+                c->str[i + b] = '0' + (d >> (c->width - 1 - b) & 1);
+    }
+
+    return 1;
+}
+
+/* COUNTER_INIT - Prepares the counter of the destination 'to' for a range with
+ * the given step, finding the incremental form of the codify, if it has one.
+-----------------------------------------------------------------------------*/
+void counter_init(struct counter *c, unsigned to, unsigned bit, unsigned long long step) {
+    c->str = c->buf;
+    c->len = 0;
+    c->live = 0;
+    c->width = 1;
+    c->lead = 0;
+    c->grow = 0;
+
+    switch (to) {
+        case BIN:
+            c->base = 2;
+            break;
+
+        case DEC:
+            c->base = 10;
+            break;
+
+        /* A sign digit first, which stays 0 for the numbers incremented */
+        case CO1:
+        case CO2:
+        case MES:
+            c->base = 2;
+            c->lead = 1;
+            break;
+
+        case BCD:
+            c->base = 10;
+            c->width = 4;
+            break;
+
+        default:
+            /* Base 1 and the codifies that are not positional (the words
+             * of the fixed-point ones are, but of a scaled value) */
+            c->base = to > SCRAP + 1 && to < QFORMAT ? to - SCRAP : 0;
+            break;
+    }
+
+    /* Only base X numbers have no fixed number of digits */
+    c->grow = !bit && (to == BIN || to == DEC || (to > SCRAP + 1 && to < QFORMAT));
+
+    for (c->steps = 0; c->base && step; step /= c->base)
+        c->step[c->steps++] = step % c->base;
+}
+
+/* COUNTER_SET - Converts the number 'n' to the destination 'i' of the request
+ * and keeps the result in the counter, which is live if the result can be
+ * incremented. Returns 1 on error, leaving the result empty.
+-----------------------------------------------------------------------------*/
+int counter_set(struct counter *c, const struct request *req, unsigned i, long long n) {
+    struct output out = {NULL, 0, 0};
+    struct value v;
+
+    value_set(&v, n);
+    c->live = 0;
+    c->len = 0;
+
+    if (codify_check(req->to[i], &v) || !conversion_to(req->to[i], &v, req->digits, req->bit, &out))
+        return 1;
+
+    c->len = out.len;
+
+    /* Results too long for the counter are written as they are */
+    if (out.len >= sizeof c->buf) {
+        c->str = out.str;
+        return 0;
+    }
+
+    c->str = c->buf + sizeof c->buf - out.len;
+    memcpy(c->str, out.str, out.len);
+    c->live = c->base && n >= 0;
+
+    return 0;
+}
+
+/* FAIL - Reports the error 'e' of a conversion: the arguments of its message
+ * follow. The code is kept in 'failure' for the JSON output, where the message
+ * is not written. Returns 1, as the conversion functions do on error.
+-----------------------------------------------------------------------------*/
+int fail(enum errors e, ...) {
+    va_list ap;
+
+    failure = e;
+
+    if (quiet || muted)
+        return 1;
+
+    va_start(ap, e);
+    vfprintf(stderr, error_text[e], ap);
+    va_end(ap);
+    fputc('\n', stderr);
+
+    return 1;
+}
+
+/* FRAC_SCAN - Stores the fractional digits 'num' (written in base X, without
+ * the point) in 'frac'. The trailing zeros are discarded.
+-----------------------------------------------------------------------------*/
+void frac_scan(const char *num, unsigned base, struct fraction *frac) {
+    unsigned len = strlen(num);
+
+    while (len && num[len - 1] == '0')
+        len--;
+
+    frac->base = base;
+    frac->len = len;
+    frac->digit = NULL;
+
+    if (!len)
+        return;
+
+    if (!(frac->digit = arena_alloc(&scratch, len))) {
+        fail(E_MEMORY);
+        frac->len = 0;
+        return;
+    }
+
+    for (unsigned i = 0; i < len; i++)
+        frac->digit[i] = isdigit(num[i]) ? num[i] - '0' : toupper(num[i]) - 'A' + 10;
+}
+
+/* FRAC_MUL - Multiplies by 'base' the fraction whose 'len' digits in base
+ * 'radix' are in 'a', and returns the integer part of the product (the carry
+ * coming out of the first digit).
+-----------------------------------------------------------------------------*/
+unsigned frac_mul(unsigned char *a, unsigned len, unsigned base, unsigned radix) {
+    unsigned carry = 0;
+
+    for (unsigned i = len; i > 0; i--) {
+        unsigned t = a[i - 1] * base + carry;
+
+        a[i - 1] = t % radix;
+        carry = t / radix;
+    }
+
+    return carry;
+}
+
+/* FRAC_TO_BITS - Writes in 'bits' the first n <= 64 binary digits of a
+ * fraction, as the integer part of frac * 2^n, and returns what is left after
+ * them: 0 if nothing, 1 if less than half a unit of the last digit, 2 if
+ * exactly half, 3 if more; -1 on error. As in frac_to_rad(), a fraction that
+ * can be written as num/den with den <= 2^64 takes a 128-bit division for up
+ * to 63 digits at a time, the others are multiplied as a big number.
+-----------------------------------------------------------------------------*/
+int frac_to_bits(const struct fraction *frac, unsigned n, uint64_t *bits) {
+    const unsigned __int128 max = (unsigned __int128) 1 << 64;
+    unsigned __int128 num = 0, den = 1;
+    unsigned i, len = frac->len;
+    unsigned char *a;
+
+    *bits = 0;
+
+    for (i = 0; i < len && den <= max / frac->base; i++) {
+        num = num * frac->base + frac->digit[i];
+        den *= frac->base;
+    }
+
+    /* Fast path: num < den <= 2^64, so num * 2^63 fits in 128 bits */
+    if (i == len) {
+        for (unsigned k = 0, s; k < n; k += s) {
+            s = n - k < 63 ? n - k : 63;
+            num <<= s;
+            *bits = *bits << s | (uint64_t) (num / den);
+            num %= den;
+        }
+
+        return !num ? 0 : 2 * num < den ? 1 : 2 * num == den ? 2 : 3;
+    }
+
+    if (!(a = arena_alloc(&scratch, len))) {
+        fail(E_MEMORY);
+        return -1;
+    }
+
+    memcpy(a, frac->digit, len);
+
+    for (i = 0; i < n; i++)
+        *bits = *bits << 1 | frac_mul(a, len, 2, frac->base);
+
+    /* The next digit, and whether any other follows */
+    i = frac_mul(a, len, 2, frac->base);
+
+    while (len && !a[len - 1])
+        len--;
+
+    return 2 * i + (len > 0);
+}
+
+/* FRAC_TO_RAD - Writes the digits of a fraction in base X, multiplying it by
+ * base and taking the integer part at each step (e.g. 0.05 in base 2 is
+ * 0.1 -> 0, 0.2 -> 0, 0.4 -> 0, 0.8 -> 0, 1.6 -> 1, ...).
+ *
+ * With n >= 0, n digits are written and the last one is rounded to nearest
+ * (ties to even). With n == SHORTEST, digits are written until the number
+ * they represent, read back with as many digits as the source, is the source
+ * number: since the source has 'len' digits in base 'radix', this is when it
+ * is closer than half a unit in the last place, radix^-len / 2.
+ *
+ * When the fraction can be written as num/den with den <= 2^64 the products
+ * fit in 128 bits and a single division gives each digit. Otherwise the source
+ * digits are multiplied as a big number (see frac_mul()). Both ways are exact.
+ * Returns 1 if the fraction was rounded up to 1, 0 otherwise, -1 on error.
+ * With n == 0 no digit decides a tie, which is returned as 2.
+-----------------------------------------------------------------------------*/
+int frac_to_rad(const struct fraction *frac, unsigned base, int n, char *str) {
+    const unsigned __int128 max = (unsigned __int128) 1 << 64;
+    unsigned __int128 num = 0, den = 1, ulp = 1;
+    unsigned i, d = 0, len = frac->len, up;
+
+    for (i = 0; i < len && den <= max / frac->base; i++) {
+        num = num * frac->base + frac->digit[i];
+        den *= frac->base;
+    }
+
+    /* Fast path */
+    if (i == len) {
+        /* After i digits the error is num / (den * base^i) and the half unit
+         * is 1 / (2 * den): 'ulp' keeps base^i, up to where it stops mattering */
+        for (i = 0; n == SHORTEST || i < (unsigned) n; i++) {
+            num *= base;
+            d = num / den;
+            num -= d * den;
+            str[i] = d < 10 ? d + '0' : d - 10 + 'A';
+
+            if (n == SHORTEST) {
+                if (ulp <= 2 * den)
+                    ulp *= base;
+
+                if (2 * num < ulp || 2 * (den - num) < ulp) {
+                    i++;
+                    break;
+                }
+            }
+        }
+
+        up = 2 * num > den ? 1 : 2 * num == den ? 2 : 0;
+    }
+
+    /* Big number: 'a' is the fraction and 'u' is base^i / den, as an integer
+     * digit followed by 'len' digits in base 'radix'. 's' is a scratch area */
+    else {
+        unsigned char *a = arena_alloc(&scratch, 3 * len + 1), *u = a + len, *s = u + len + 1;
+        unsigned two, rest, c;
+
+        if (!a) {
+            fail(E_MEMORY);
+            return -1;
+        }
+
+        memcpy(a, frac->digit, len);
+        memset(u, 0, len + 1);
+        u[len] = 1;
+
+        for (i = 0; n == SHORTEST || i < (unsigned) n; i++) {
+            d = frac_mul(a, len, base, frac->base);
+            str[i] = d < 10 ? d + '0' : d - 10 + 'A';
+
+            if (n != SHORTEST) {
+                /* Digits that became zero at the end are no longer needed */
+                while (len && !a[len - 1])
+                    len--;
+
+                continue;
+            }
+
+            if (u[0] < 2)
+                u[0] = u[0] * base + frac_mul(u + 1, len, base, frac->base);
+
+            /* Truncating is close enough if 2 * a < u */
+            memcpy(s, a, len);
+            two = frac_mul(s, len, 2, frac->base);
+
+            if (two < u[0] || (two == u[0] && memcmp(s, u + 1, len) < 0)) {
+                i++;
+                break;
+            }
+
+            /* Rounding up is close enough if 2 * (1 - a) < u, i.e. 2 * a + u > 2 */
+            c = 0;
+            rest = 0;
+
+            for (unsigned j = len, t; j > 0; j--) {
+                t = s[j - 1] + u[j] + c;
+                s[j - 1] = t % frac->base;
+                c = t / frac->base;
+                rest |= s[j - 1];
+            }
+
+            if ((c += two + u[0]) > 2 || (c == 2 && rest)) {
+                i++;
+                break;
+            }
+        }
+
+        /* Round up if 2 * a > 1, to even if 2 * a == 1 */
+        two = frac_mul(a, len, 2, frac->base);
+        rest = 0;
+
+        for (unsigned j = 0; j < len; j++)
+            rest |= a[j];
+
+        up = two ? (rest ? 1 : 2) : 0;
+    }
+
+    str[i] = '\0';
+
+    /* A tie is rounded to the even last digit (or left to the caller) */
+    if (up == 2 && i)
+        up = d % 2;
+
+    /* Round up the written digits, from the last one: the largest digit of
+     * the base turns to 0 */
+    const char top = base - 1 < 10 ? base - 1 + '0' : base - 11 + 'A';
+
+    while (up == 1 && i > 0) {
+        if (str[i - 1] == top)
+            str[--i] = '0';
+
+        else {
+            str[i - 1] = str[i - 1] == '9' ? 'A' : str[i - 1] + 1;
+            up = 0;
+        }
+    }
+
+    return up;
+}
+
+/* GROUP_DECODE - Decodes the 16 symbols at 'in' of RFC 4648 Base32 (bits =
+ * 5, also in lower case) or Base64 (bits = 6), writing 10 or 12 bytes at
+ * 'out'. The symbols are classified as a vector by comparing them with the
+ * bounds of their ranges; the values are then packed, 8 at a time, in the bits
+ * of a word. Returns 1 if one of them is not a symbol of the base.
+-----------------------------------------------------------------------------*/
+int group_decode(const char *in, unsigned bits, unsigned char *out) {
+    typedef unsigned char bytes __attribute__((vector_size(16)));
+    uint64_t w[2], ok[2];
+    bytes c, up, low, num, val, valid;
+
+    memcpy(&c, in, sizeof c);
+    up = (bytes) (c >= 'A') & (bytes) (c <= 'Z');
+    low = (bytes) (c >= 'a') & (bytes) (c <= 'z');
+
+    if (bits == 6) {
+        bytes plus = (bytes) (c == '+'), slash = (bytes) (c == '/');
+
+        num = (bytes) (c >= '0') & (bytes) (c <= '9');
+        val = (up & (c - 65)) | (low & (c - 71)) | (num & (c + 4)) | (plus & 62) | (slash & 63);
+        valid = up | low | num | plus | slash;
+
+    } else {
+        num = (bytes) (c >= '2') & (bytes) (c <= '7');
+        val = (up & (c - 65)) | (low & (c - 97)) | (num & (c - 24));
+        valid = up | low | num;
+    }
+
+    memcpy(ok, &valid, sizeof ok);
+
+    if (~ok[0] | ~ok[1])
+        return 1;
+
+    memcpy(w, &val, sizeof w);
+
+    for (unsigned h = 0; h < 2; h++) {
+        uint64_t x = 0;
+
+        for (unsigned i = 0; i < 8; i++)
+            x |= (w[h] >> 8 * i & 0xFF) << bits * (7 - i);
+
+        x = __builtin_bswap64(x << (64 - 8 * bits));
+        memcpy(out + h * bits, &x, bits);
+    }
+
+    return 0;
+}
+
+/* GROUP_ENCODE - Encodes 12 bytes at 'in' as 16 symbols of RFC 4648 Base64
+ * (bits = 6), or 10 bytes as 16 symbols of Base32 (bits = 5), at 'out'; the
+ * 16 bytes at 'in' must be readable. The bits of each half are spread in the
+ * bytes of a word, then a vector turns the 16 values in ASCII: each range of
+ * values has its own offset, added where a comparison selects it.
+-----------------------------------------------------------------------------*/
+void group_encode(const unsigned char *in, unsigned bits, char *out) {
+    typedef unsigned char bytes __attribute__((vector_size(16)));
+    uint64_t w[2];
+    bytes v;
+
+    for (unsigned h = 0; h < 2; h++) {
+        uint64_t x;
+
+        memcpy(&x, in + h * bits, sizeof x);
+        x = __builtin_bswap64(x) >> (64 - 8 * bits);
+        w[h] = 0;
+
+        for (unsigned i = 0; i < 8; i++)
+            w[h] |= (x >> bits * (7 - i) & ((1u << bits) - 1)) << 8 * i;
+    }
+
+    memcpy(&v, w, sizeof v);
+
+    if (bits == 6)
+        v += 65 + ((bytes) (v > 25) & 6) - ((bytes) (v > 51) & 75) - ((bytes) (v > 61) & 15) + ((bytes) (v > 62) & 3);
+    else
+        v += 65 - ((bytes) (v > 25) & 41);
+
+    memcpy(out, &v, sizeof v);
+}
+
+/* JSON_NUMBER - Writes a natural number at the end of the output.
+-----------------------------------------------------------------------------*/
+void json_number(struct output *out, unsigned long n) {
+    char digits[24];
+    unsigned len = 0;
+    char *p;
+
+    do
+        digits[sizeof digits - ++len] = '0' + n % 10;
+    while (n /= 10);
+
+    if ((p = out_reserve(out, len)))
+        memcpy(p, digits + sizeof digits - len, len);
+}
+
+/* JSON_STRING - Writes a string at the end of the output as a JSON string:
+ * quotes, backslashes and control characters are escaped.
+-----------------------------------------------------------------------------*/
+void json_string(struct output *out, const char *str) {
+    static const char hex[] = "0123456789abcdef";
+    size_t len = 2;
+    char *p;
+
+    for (const unsigned char *s = (const unsigned char *) str; *s; s++)
+        len += *s < 0x20 ? 6 : *s == '"' || *s == '\\' ? 2 : 1;
+
+    if (!(p = out_reserve(out, len)))
+        return;
+
+    *p++ = '"';
+
+    for (const unsigned char *s = (const unsigned char *) str; *s; s++)
+        if (*s < 0x20) {
+            memcpy(p, "\\u00", 4);
+            p[4] = hex[*s >> 4];
+            p[5] = hex[*s & 15];
+            p += 6;
+
+        } else {
+            if (*s == '"' || *s == '\\')
+                *p++ = '\\';
+
+            *p++ = *s;
+        }
+
+    *p = '"';
+}
+
+/* OUT_PUTS - Writes a string at the end of the output.
+-----------------------------------------------------------------------------*/
+const char *out_puts(struct output *out, const char *str) {
+    size_t len = strlen(str);
+    char *p = out_reserve(out, len);
+
+    if (!p)
+        return NULL;
+
+    memcpy(p, str, len);
+
+    return out->str;
+}
+
+/* OUT_RESERVE - Takes room for n more characters at the end of the output and
+ * returns where they start. If the buffer is too small, a larger one is taken
+ * from the arena. The text is kept terminated.
+-----------------------------------------------------------------------------*/
+char *out_reserve(struct output *out, size_t n) {
+    if (out->len + n >= out->size) {
+        size_t size = 2 * (out->len + n) + 64;
+        char *str = arena_alloc(&scratch, size);
+
+        if (!str) {
+            fail(E_MEMORY);
+            return NULL;
+        }
+
+        if (out->len)
+            memcpy(str, out->str, out->len);
+
+        out->str = str;
+        out->size = size;
+    }
+
+    out->len += n;
+    out->str[out->len] = '\0';
+
+    return out->str + out->len - n;
+}
+
+/* RAD_LEN - Returns the number of digits of an integer in base X.
+-----------------------------------------------------------------------------*/
+unsigned rad_len(long double num, unsigned base) {
+    unsigned len = 1;
+
+    for (long double p = base; p <= num; p *= base)
+        len++;
+
+    return len;
+}
+
+/* REMOVE_SYMBOLS - Removes everything other than a number.
+-----------------------------------------------------------------------------*/
+const char *remove_symbols(char *str) {
+    for (unsigned i = 0, j = 0; i < strlen(str) + 1; i++)
+        if (isdigit(str[i]) || str[i] == '\0')
+            str[j++] = str[i];
+    return str;
+}
+
+/* TABLE_BUILD - Writes the entries of the block 'b' of a table, converting each
+ * integer as conversion_to() would. Their errors are not reported.
+-----------------------------------------------------------------------------*/
+void table_build(struct table *t, unsigned b) {
+    enum errors saved = failure;
+
+    muted = 1;
+
+    for (unsigned i = b * TABLE_BLOCK; i < (b + 1) * TABLE_BLOCK; i++) {
+        struct output out = {NULL, 0, 0};
+        struct value v;
+
+        value_set(&v, (long) i - TABLE_LOW);
+        t->slot[i][0] = TABLE_SLOT;
+
+        if (!codify_check(t->to, &v) && conversion_write(t->to, &v, 0, t->bit, &out) && out.len < TABLE_SLOT) {
+            memcpy(t->slot[i] + 1, out.str, out.len);
+            t->slot[i][0] = out.len;
+        }
+    }
+
+    muted = 0;
+    failure = saved;
+}
+
+/* TABLE_GET - Writes at the end of the output the result of the integer 'v' in
+ * the codify 'to' with 'bit' bits, copying it from the table of the codify,
+ * if 'v' is between -TABLE_LOW and TABLE_HIGH - 1 and the codify has one. The
+ * block of the entry is built first if no thread has done it yet; while
+ * another one is building it, the number is not taken from the table. Only
+ * the codifies whose results depend on no other option have tables.
+ * Returns the output, or NULL if the number must be converted.
+-----------------------------------------------------------------------------*/
+const char *table_get(unsigned to, const struct value *v, unsigned bit, struct output *out) {
+    struct table *t = NULL;
+    unsigned i, n, b;
+    pid_t builder = 0;
+    char *p;
+
+    if (!(to == BCD || to == BIN || to == CO1 || to == CO2 || to == DEC || to == MES ||
+          (to > SCRAP + 1 && to < QFORMAT)))
+        return NULL;
+
+    /* Integers only, and not -0, which some codifies write with the minus */
+    if (v->frac.len || v->big.n || v->whole >= (v->sign ? TABLE_LOW + 1 : TABLE_HIGH) || (v->sign && !v->whole))
+        return NULL;
+
+    i = v->sign ? TABLE_LOW - (unsigned) v->whole : TABLE_LOW + (unsigned) v->whole;
+    n = __atomic_load_n(&tables, __ATOMIC_ACQUIRE);
+
+    for (unsigned k = 0; k < n && !t; k++)
+        if (table[k]->to == to && table[k]->bit == bit)
+            t = table[k];
+
+    if (!t && !(t = table_open(to, bit)))
+        return NULL;
+
+    b = i / TABLE_BLOCK;
+
+    if (!__atomic_load_n(&t->built[b], __ATOMIC_ACQUIRE)) {
+        /* A claim is given up only by a process that has ended (with -T, a
+         * killed one); one of the same process is a thread still building */
+        if (!__atomic_compare_exchange_n(&t->builder[b], &builder, getpid(), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) &&
+            (builder == getpid() || !kill(builder, 0) || errno != ESRCH ||
+             !__atomic_compare_exchange_n(&t->builder[b], &builder, getpid(), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)))
+            return NULL;
+
+        if (!__atomic_load_n(&t->built[b], __ATOMIC_ACQUIRE)) {
+            table_build(t, b);
+            __atomic_store_n(&t->built[b], 1, __ATOMIC_RELEASE);
+        }
+    }
+
+    if (t->slot[i][0] >= TABLE_SLOT || !(p = out_reserve(out, t->slot[i][0])))
+        return NULL;
+
+    memcpy(p, t->slot[i] + 1, t->slot[i][0]);
+
+    return out->str;
+}
+
+/* TABLE_OPEN - Returns the table of the codify 'to' with 'bit' bits, opening
+ * it if it is not open yet: it is mapped from its file in the directory of
+ * option -T, which is created (or emptied, if it has another format) while
+ * it is locked, or else from anonymous memory: also when the directory cannot
+ * be used, which is then given up. Its pages are taken only when their blocks
+ * are built. Returns NULL if it cannot be opened.
+-----------------------------------------------------------------------------*/
+struct table *table_open(unsigned to, unsigned bit) {
+    struct table *t = NULL;
+    char name[PATH_MAX];
+    struct stat st;
+    int fd = -1;
+
+    pthread_mutex_lock(&table_lock);
+
+    for (unsigned k = 0; k < tables; k++)
+        if (table[k]->to == to && table[k]->bit == bit) {
+            pthread_mutex_unlock(&table_lock);
+            return table[k];
+        }
+
+    if (tables == TABLES) {
+        pthread_mutex_unlock(&table_lock);
+        return NULL;
+    }
+
+    if (table_dir) {
+        snprintf(name, sizeof name, "%s/baco-%u-%u.tab", table_dir, to, bit);
+
+        if ((fd = open(name, O_RDWR | O_CREAT, 0644)) >= 0 && !flock(fd, LOCK_EX) && !fstat(fd, &st) &&
+            (st.st_size == sizeof(struct table) || !ftruncate(fd, sizeof(struct table))) &&
+            (t = mmap(NULL, sizeof(struct table), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+            t = NULL;
+
+        /* Said once: the next tables are not looked for in the directory */
+        if (!t) {
+            fprintf(stderr, "%s: %s; the tables are kept in memory.\n", name, strerror(errno));
+            table_dir = NULL;
+        }
+
+        /* A new file, or one of another format, is started over */
+        if (t && (strncmp(t->magic, "BACO table", sizeof t->magic) || t->format != TABLE_FORMAT ||
+                  t->size != sizeof(struct table) || t->to != to || t->bit != bit)) {
+            memset(t->builder, 0, sizeof t->builder);
+            memset(t->built, 0, sizeof t->built);
+            strcpy(t->magic, "BACO table");
+            t->format = TABLE_FORMAT;
+            t->size = sizeof(struct table);
+            t->to = to;
+            t->bit = bit;
+        }
+
+        if (fd >= 0)
+            close(fd);
+    }
+
+    if (!table_dir) {
+        if ((t = mmap(NULL, sizeof(struct table), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) ==
+            MAP_FAILED)
+            t = NULL;
+
+        else {
+            t->to = to;
+            t->bit = bit;
+        }
+    }
+
+    if (t) {
+        table[tables] = t;
+        __atomic_store_n(&tables, tables + 1, __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_unlock(&table_lock);
+
+    return t;
+}
+
+/* TOKEN_BASE - Returns the codify named by the prefix at 'p' (0x, 0b or 0o,
+ * also in upper case), 0 if there is none.
+-----------------------------------------------------------------------------*/
+unsigned token_base(const char *p) {
+    if (p[0] != '0')
+        return 0;
+
+    switch (p[1]) {
+        case 'x':
+        case 'X':
+            return SCRAP + 16;
+
+        case 'b':
+        case 'B':
+            return BIN;
+
+        case 'o':
+        case 'O':
+            return SCRAP + 8;
+
         default:
-            fprintf(stderr, "The codify is not correct.\n");
-            return 1;
+            return 0;
     }
+}
 
-    switch (decimal) {
-        /* No decimal point */
-        case 0:
-            break;
+/* TOKEN_CLEAN - Finds the number in the 'len' bytes at 'num' and makes it
+ * ready for the parsers: the blanks around it, the separators of its digit
+ * groups ('_' and '\'', or blanks before groups of three) and the prefix of
+ * its base are removed. A prefix is removed only if it names the source
+ * codify 'from' (or the base of its words, for the fixed-point ones), or if
+ * this is AUTO: then it is replaced by the codify of the prefix (DEC without
+ * one). The number is left in place, ended by '\0', and its start is returned with its
+ * length in 'len'. Its bytes are moved only to close up the separators, or to
+ * keep the minus before a prefix.
+-----------------------------------------------------------------------------*/
+char *token_clean(char *num, size_t *len, unsigned *from) {
+    size_t n = *len, w, r;
+    unsigned base, sign;
 
-        /* Decimal point is present */
-        case 1: {
-            for (unsigned i = 0; i < (sizeof(code) / sizeof(struct codify)); i++)
-                if (from == code[i].id || to == code[i].id)
-                    if (!code[i].decimal) {
-                        fprintf(stderr, "%s accepts only integer.\n", code[i].name[0]);
-                        return 1;
-                    }
-            break;
+    while (n && isspace((unsigned char) num[n - 1]))
+        n--;
+
+    while (n && isspace((unsigned char) *num)) {
+        num++;
+        n--;
+    }
+
+    /* Each span without separators is moved right after the previous one.
+     * Bytes that are found but are not separators stay in the number, which
+     * is then rejected by format_scan(). A custom alphabet can have '_' and
+     * '\'' as symbols */
+    if (*from != ALF && (w = r = token_find(num, n)) < n) {
+        while (r < n) {
+            size_t span, skip = r, g;
+            int blank = 0;
+
+            while (r < n && (isspace((unsigned char) num[r]) || num[r] == '_' || num[r] == '\'')) {
+                blank |= isspace((unsigned char) num[r]);
+                r++;
+            }
+
+            /* A blank only separates groups of three digits, so that two
+             * numbers on a line (as «12 34») are not read as one */
+            for (g = r; blank && g < n && g - r < 4 && num[g] != '.' && token_find(num + g, 1); g++)
+                ;
+
+            if (blank && g - r != 3)
+                r = skip;
+
+            span = r < n ? 1 + token_find(num + r + 1, n - r - 1) : 0;
+            memmove(num + w, num + r, span);
+            w += span;
+            r += span;
+        }
+
+        n = w;
+    }
+
+    sign = n && *num == '-';
+    base = n >= sign + 2 ? token_base(num + sign) : 0;
+
+    if (*from == AUTO)
+        *from = base ? base : DEC;
+
+    else if (base != *from && !(base == BIN && (*from == SCRAP + 2 || *from == BCD || *from == CO1 ||
+                                                *from == CO2 || *from == MES)) &&
+             !(*from >= QFORMAT && base == ((*from - QFORMAT) / 32768 ? BIN : SCRAP + 16)))
+        base = 0;
+
+    if (base) {
+        if (sign)
+            num[2] = '-';
+
+        num += 2;
+        n -= 2;
+    }
+
+    num[n] = '\0';
+    *len = n;
+
+    return num;
+}
+
+/* TOKEN_FIND - Returns the position of the first byte among the 'n' at 's'
+ * that can separate the digits of a number: a blank or another control
+ * character, '_' or '\''; 'n' if there is none. The bytes are classified 16
+ * at a time as a vector, so that a number without separators is passed over
+ * with a few instructions.
+-----------------------------------------------------------------------------*/
+size_t token_find(const char *s, size_t n) {
+    typedef unsigned char bytes __attribute__((vector_size(16)));
+    const bytes blank = (bytes) {0} + ' ', under = (bytes) {0} + '_', quote = (bytes) {0} + '\'';
+    size_t i = 0;
+
+    for (; n - i >= sizeof(bytes); i += sizeof(bytes)) {
+        uint64_t hit[2];
+        bytes b, c;
+
+        memcpy(&b, s + i, sizeof(bytes));
+        c = (bytes) ((b <= blank) | (b == under) | (b == quote));
+        memcpy(hit, &c, sizeof hit);
+
+        if (hit[0] | hit[1])
+            return i + (hit[0] ? __builtin_ctzll(hit[0]) : 64 + __builtin_ctzll(hit[1])) / 8;
+    }
+
+    for (; i < n; i++)
+        if ((unsigned char) s[i] <= ' ' || s[i] == '_' || s[i] == '\'')
+            return i;
+
+    return n;
+}
+
+/* U64_TO_RAD - Writes the digits of x in base X just before 'end' and returns
+ * how many they are (the 64 bytes before 'end' must be free). Base 16 digits
+ * are made 16 at once: the bytes of x, most significant first, are split in
+ * nibbles that a vector turns in ASCII. Base 2 digits are made 8 at once, the
+ * bits of a byte spread over the bytes of a word. Base 10 digits are taken two
+ * at a time from a table of the pairs 00-99.
+-----------------------------------------------------------------------------*/
+unsigned u64_to_rad(uint64_t x, unsigned base, char *end) {
+    typedef unsigned char bytes __attribute__((vector_size(16)));
+    static const char pairs[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+    uint64_t be = __builtin_bswap64(x);
+    unsigned len = 0;
+    bytes v = {0};
+
+    switch (base) {
+        case 16: {
+            bytes d;
+
+            memcpy(&v, &be, sizeof be);
+            d = __builtin_shuffle(v >> 4, v & 15, (bytes) {0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23});
+            d += '0' + ((bytes) (d > 9) & 7);
+            memcpy(end - 16, &d, 16);
+
+            return x ? 16 - __builtin_clzll(x) / 4 : 1;
+        }
+
+        case 2:
+            for (unsigned i = 0; i < 8; i++) {
+                /* The byte in every byte of a word, each keeping one bit, the
+                 * most significant first in memory: 0x80 + 0x7F has no carry */
+                uint64_t w = (be >> 8 * i & 0xFF) * 0x0101010101010101ULL & 0x0102040810204080ULL;
+
+                w = ((w + 0x7F7F7F7F7F7F7F7FULL) >> 7 & 0x0101010101010101ULL) + 0x3030303030303030ULL;
+                memcpy(end - 64 + 8 * i, &w, 8);
+            }
+
+            return x ? 64 - __builtin_clzll(x) : 1;
+
+        case 8:
+            do
+                *(end - ++len) = '0' + (x & 7);
+            while (x >>= 3);
+
+            return len;
+
+        case 10:
+            for (; x >= 100; x /= 100, len += 2)
+                memcpy(end - len - 2, pairs + 2 * (x % 100), 2);
+
+            if (x >= 10) {
+                memcpy(end - len - 2, pairs + 2 * x, 2);
+                return len + 2;
+            }
+
+            *(end - len - 1) = '0' + x;
+            return len + 1;
+
+        default:
+            do {
+                unsigned d = x % base;
+
+                *(end - ++len) = d < 10 ? d + '0' : d - 10 + 'A';
+            } while (x /= base);
+
+            return len;
+    }
+}
+
+/* UNARY_ZEROS - Returns how many of the n bytes at 'buf' are '0', the digit of
+ * the unary base. The bytes are compared 16 at a time as a vector: each equal
+ * byte gives -1, subtracted in a counter per byte that is added up before it
+ * can overflow (every 255 vectors).
+-----------------------------------------------------------------------------*/
+size_t unary_zeros(const char *buf, size_t n) {
+    typedef signed char bytes __attribute__((vector_size(16)));
+    const bytes zero = (bytes) {0} + '0';
+    size_t count = 0, i = 0;
+
+    while (n - i >= sizeof(bytes)) {
+        bytes sum = {0};
+
+        for (unsigned r = 0; r < 255 && n - i >= sizeof(bytes); r++, i += sizeof(bytes)) {
+            bytes b;
+
+            memcpy(&b, buf + i, sizeof(bytes));
+            sum -= b == zero;
+        }
+
+        for (unsigned j = 0; j < sizeof(bytes); j++)
+            count += (unsigned char) sum[j];
+    }
+
+    for (; i < n; i++)
+        count += buf[i] == '0';
+
+    return count;
+}
+
+/* VALUE_BIG - Fills 'v' with the natural number of the 'n' limbs at 'd' (in
+ * the arena), as a big number if they are more than one.
+-----------------------------------------------------------------------------*/
+void value_big(struct value *v, uint64_t *d, size_t n) {
+    if (n < 2) {
+        value_set(v, n ? d[0] : 0);
+        return;
+    }
+
+    v->big = (struct big) {d, n};
+    v->whole = big_value(v->big);
+    v->x = v->whole;
+    v->sign = 0;
+    v->frac = (struct fraction) {2, 0, NULL};
+}
+
+/* VALUE_BYTES - Returns the bytes of the natural number 'v', most significant
+ * first, and their number in 'n' (at least one). They are followed by 16 zeros.
+-----------------------------------------------------------------------------*/
+unsigned char *value_bytes(const struct value *v, size_t *n) {
+    size_t limbs = v->big.n ? v->big.n : 1, skip = 0;
+    unsigned char *b;
+
+    if (!v->big.n && v->whole >= 0x1p64L) {
+        fail(E_LARGE);
+        return NULL;
+    }
+
+    if (!(b = arena_alloc(&scratch, 8 * limbs + 16))) {
+        fail(E_MEMORY);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < limbs; i++) {
+        uint64_t x = __builtin_bswap64(v->big.n ? v->big.d[i] : (uint64_t) v->whole);
+
+        memcpy(b + 8 * (limbs - 1 - i), &x, 8);
+    }
+
+    memset(b + 8 * limbs, 0, 16);
+
+    while (skip + 1 < 8 * limbs && !b[skip])
+        skip++;
+
+    *n = 8 * limbs - skip;
+
+    return b + skip;
+}
+
+/* VALUE_SET - Fills 'v' from a value, whose integer part fits in 'whole' (it
+ * has no big part). The fractional part of a long double is a binary
+ * fraction, so it is stored exactly as base 2 digits: doubling it and
+ * removing the integer part never rounds.
+-----------------------------------------------------------------------------*/
+void value_set(struct value *v, long double x) {
+    long double f = modfl(fabsl(x), &v->whole);
+    int exp;
+
+    v->x = x;
+    v->sign = x < 0;
+    v->big = (struct big) {NULL, 0};
+    v->frac.base = 2;
+    v->frac.len = 0;
+    v->frac.digit = NULL;
+
+    if (!f)
+        return;
+
+    /* f = m * 2^exp with 0.5 <= m < 1: it has at most LDBL_MANT_DIG - exp bits */
+    frexpl(f, &exp);
+
+    if (!(v->frac.digit = arena_alloc(&scratch, LDBL_MANT_DIG - exp))) {
+        fail(E_MEMORY);
+        return;
+    }
+
+    while (f) {
+        f *= 2;
+        v->frac.digit[v->frac.len++] = f >= 1;
+
+        if (f >= 1)
+            f -= 1;
+    }
+}
+
+/*=============================================================================
+ * BIG NUMBER FUNCTIONS
+=============================================================================*/
+
+/* BIG_ADD - Writes a + b in r (which may be a) and returns the carry. 'a' has
+ * 'an' limbs, 'b' has 'bn' <= an limbs and r has room for an limbs.
+-----------------------------------------------------------------------------*/
+uint64_t big_add(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn) {
+    uint64_t carry = 0;
+
+    for (size_t i = 0; i < an; i++) {
+        uint64_t t = a[i] + carry;
+
+        carry = t < carry;
+
+        if (i < bn) {
+            t += b[i];
+            carry += t < b[i];
+        }
+
+        r[i] = t;
+    }
+
+    return carry;
+}
+
+/* BIG_ALLOC - Returns n limbs set to 0, and one more so that a carry can
+ * always be added. Big numbers cannot be converted without their memory, so
+ * the program ends if there is none.
+-----------------------------------------------------------------------------*/
+uint64_t *big_alloc(size_t n) {
+    uint64_t *d = calloc(n + 1, sizeof(uint64_t));
+
+    if (!d) {
+        fprintf(stderr, "Memory allocation error.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return d;
+}
+
+/* BIG_BITS - Returns the number of bits of a big number.
+-----------------------------------------------------------------------------*/
+size_t big_bits(struct big x) {
+    return x.n ? 64 * x.n - __builtin_clzll(x.d[x.n - 1]) : 0;
+}
+
+/* BIG_CMP - Compares two big numbers, as strcmp() does with strings.
+-----------------------------------------------------------------------------*/
+int big_cmp(struct big a, struct big b) {
+    if (a.n != b.n)
+        return a.n < b.n ? -1 : 1;
+
+    for (size_t i = a.n; i > 0; i--)
+        if (a.d[i - 1] != b.d[i - 1])
+            return a.d[i - 1] < b.d[i - 1] ? -1 : 1;
+
+    return 0;
+}
+
+/* BIG_DEPTH - Returns how many times the conversion of a big number can be
+ * split between two threads: once for every doubling of the processors. The
+ * threads actually started are also bounded by big_spawn(), since the nested
+ * products split again.
+-----------------------------------------------------------------------------*/
+int big_depth(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int depth = 0;
+
+    while ((2L << depth) <= cpus)
+        depth++;
+
+    return depth;
+}
+
+/* BIG_DIVMOD - Divides x < pow[j]^2 by pow[j] (Barrett): the quotient is
+ * estimated multiplying by the reciprocal, and it is at most 2 units short.
+-----------------------------------------------------------------------------*/
+void big_divmod(struct big x, const struct power *pw, unsigned j, struct big *q, struct big *r, int depth) {
+    const uint64_t one = 1;
+    struct big t = big_product(x, pw->inv[j], depth);
+
+    *q = big_shr(t, 2 * pw->bits[j]);
+    free(t.d);
+
+    t = big_product(*q, pw->pow[j], depth);
+    r->d = big_alloc(x.n);
+    r->n = x.n;
+    big_sub(r->d, x.d, x.n, t.d, t.n);
+    *r = big_norm(*r);
+    free(t.d);
+
+    while (big_cmp(*r, pw->pow[j]) >= 0) {
+        big_sub(r->d, r->d, r->n, pw->pow[j].d, pw->pow[j].n);
+        *r = big_norm(*r);
+        q->d[q->n] = q->n ? big_add(q->d, q->d, q->n, &one, 1) : 1;
+        q->n++;
+        *q = big_norm(*q);
+    }
+}
+
+/* BIG_FORK - Runs f() on two jobs: the first one on a new thread if 'depth' > 0
+ * and a thread can be started (see big_spawn()), the second one on this thread.
+-----------------------------------------------------------------------------*/
+void big_fork(void *(*f)(void *), struct job *a, struct job *b, int depth) {
+    pthread_t t;
+    int forked = depth > 0 && big_spawn(&t, f, a);
+
+    if (!forked)
+        f(a);
+
+    f(b);
+
+    if (forked)
+        big_join(t);
+}
+
+/* BIG_JOIN - Waits for a thread started by big_spawn(), and frees its place.
+-----------------------------------------------------------------------------*/
+void big_join(pthread_t t) {
+    pthread_join(t, NULL);
+    __atomic_sub_fetch(&big_threads, 1, __ATOMIC_RELAXED);
+}
+
+/* BIG_KARATSUBA - Writes in r (2n limbs) the product of a and b (n limbs): with
+ * a = a1 * B^h + a0 and b = b1 * B^h + b0 it is a1 * b1 * B^2h + a0 * b0 +
+ * ((a1 + a0) * (b1 + b0) - a1 * b1 - a0 * b0) * B^h, that is three products
+ * of half the size. The first two are given to other threads if 'depth' > 0
+ * and there are processors left for them (see big_spawn()).
+-----------------------------------------------------------------------------*/
+void big_karatsuba(uint64_t *r, const uint64_t *a, const uint64_t *b, size_t n, int depth) {
+    size_t h = n / 2, m = n - h;
+    struct job low = {.r = r, .a = a, .b = b, .n = h, .depth = depth - 1},
+            high = {.r = r + 2 * h, .a = a + h, .b = b + h, .n = m, .depth = depth - 1};
+    pthread_t t0, t2;
+    int f0, f2;
+
+    if (n < KARATSUBA) {
+        big_mul_base(r, a, n, b, n);
+        return;
+    }
+
+    uint64_t *t = big_alloc(4 * m + 4), *sa = t, *sb = t + m + 1, *z1 = t + 2 * m + 2;
+
+    sa[m] = big_add(sa, a + h, m, a, h);
+    sb[m] = big_add(sb, b + h, m, b, h);
+
+    f0 = depth > 0 && big_spawn(&t0, big_mul_job, &low);
+    f2 = depth > 0 && big_spawn(&t2, big_mul_job, &high);
+
+    if (!f0)
+        big_mul_job(&low);
+
+    if (!f2)
+        big_mul_job(&high);
+
+    big_karatsuba(z1, sa, sb, m + 1, depth - 1);
+
+    if (f0)
+        big_join(t0);
+
+    if (f2)
+        big_join(t2);
+
+    big_sub(z1, z1, 2 * m + 2, r, 2 * h);
+    big_sub(z1, z1, 2 * m + 2, r + 2 * h, 2 * m);
+    big_add(r + h, r + h, 2 * n - h, z1, 2 * m + 2);
+
+    free(t);
+}
+
+/* BIG_MUL - Writes in r (an + bn limbs) the product of a and b. Products of
+ * different sizes are made of products of the size of the shorter number.
+-----------------------------------------------------------------------------*/
+void big_mul(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn, int depth) {
+    if (an < bn) {
+        big_mul(r, b, bn, a, an, depth);
+        return;
+    }
+
+    if (bn < KARATSUBA) {
+        big_mul_base(r, a, an, b, bn);
+        return;
+    }
+
+    if (an == bn) {
+        big_karatsuba(r, a, b, bn, depth);
+        return;
+    }
+
+    uint64_t *t = big_alloc(2 * bn);
+
+    memset(r, 0, (an + bn) * sizeof(uint64_t));
+
+    for (size_t i = 0; i < an; i += bn) {
+        size_t len = an - i < bn ? an - i : bn;
+
+        big_mul(t, a + i, len, b, bn, depth);
+        big_add(r + i, r + i, an + bn - i, t, len + bn);
+    }
+
+    free(t);
+}
+
+/* BIG_MUL_BASE - Writes in r (an + bn limbs) the product of a and b, limb by
+ * limb as it is done by hand.
+-----------------------------------------------------------------------------*/
+void big_mul_base(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn) {
+    memset(r, 0, (an + bn) * sizeof(uint64_t));
+
+    for (size_t i = 0; i < bn; i++) {
+        uint64_t carry = 0;
+
+        for (size_t j = 0; j < an; j++) {
+            unsigned __int128 t = (unsigned __int128) a[j] * b[i] + r[i + j] + carry;
+
+            r[i + j] = t;
+            carry = t >> 64;
+        }
+
+        r[i + an] = carry;
+    }
+}
+
+/* BIG_MUL_JOB - big_karatsuba() run by a thread.
+-----------------------------------------------------------------------------*/
+void *big_mul_job(void *arg) {
+    struct job *j = arg;
+
+    big_karatsuba(j->r, j->a, j->b, j->n, j->depth);
+
+    return NULL;
+}
+
+/* BIG_NORM - Drops the most significant limbs that are 0.
+-----------------------------------------------------------------------------*/
+struct big big_norm(struct big x) {
+    while (x.n && !x.d[x.n - 1])
+        x.n--;
+
+    return x;
+}
+
+/* BIG_POWER - Fills 'pw' with the powers of the base needed to split a number
+ * of n digits: pow[0] = base^k is the largest one that fits in a limb and
+ * each one is the square of the previous one. With 'inverse' the reciprocals
+ * needed by big_divmod() are computed too. pow[0] is always there. The powers
+ * of two bases are never needed, since their digits are groups of bits.
+-----------------------------------------------------------------------------*/
+void big_power(struct power *pw, unsigned base, size_t n, int inverse, int depth) {
+    uint64_t p = base;
+
+    pw->base = base;
+    pw->k = 1;
+    pw->levels = 0;
+
+    while (p <= UINT64_MAX / base) {
+        p *= base;
+        pw->k++;
+    }
+
+    if (!(base & (base - 1)))
+        return;
+
+    for (unsigned j = 0; j < 64 && (!j || ((size_t) pw->k << j) < n); j++) {
+        if (j)
+            pw->pow[j] = big_product(pw->pow[j - 1], pw->pow[j - 1], depth);
+
+        else {
+            pw->pow[0].d = big_alloc(1);
+            pw->pow[0].d[0] = p;
+            pw->pow[0].n = 1;
+        }
+
+        pw->bits[j] = big_bits(pw->pow[j]);
+        pw->inv[j] = inverse ? big_recip(pw->pow[j], pw->bits[j], depth) : (struct big) {NULL, 0};
+        pw->levels++;
+    }
+}
+
+/* BIG_POWER_FREE - Frees the powers made by big_power().
+-----------------------------------------------------------------------------*/
+void big_power_free(struct power *pw) {
+    for (unsigned j = 0; j < pw->levels; j++) {
+        free(pw->pow[j].d);
+        free(pw->inv[j].d);
+    }
+
+    pw->levels = 0;
+}
+
+/* BIG_PRODUCT - Returns a * b.
+-----------------------------------------------------------------------------*/
+struct big big_product(struct big a, struct big b, int depth) {
+    struct big r = {big_alloc(a.n + b.n), a.n && b.n ? a.n + b.n : 0};
+
+    if (r.n)
+        big_mul(r.d, a.d, a.n, b.d, b.n, depth);
+
+    return big_norm(r);
+}
+
+/* BIG_READ - Returns the value of the n digits 'str' in base X. The digits are
+ * split where the lower part has k * 2^j of them: the two parts are read
+ * (by two threads if 'depth' > 0) and the value is high * pow[j] + low.
+ * Short numbers are read k digits at a time, multiplying by base^k.
+-----------------------------------------------------------------------------*/
+struct big big_read(const char *str, size_t n, const struct power *pw, int depth) {
+    unsigned base = pw->base, k = pw->k, j = 0;
+    struct big x;
+
+    /* Powers of two: each digit is a group of bits */
+    if (!(base & (base - 1))) {
+        unsigned b = __builtin_ctz(base);
+
+        x.n = (n * b + 63) / 64;
+        x.d = big_alloc(x.n);
+
+        for (size_t i = 0; i < n; i++) {
+            char c = str[n - 1 - i];
+            uint64_t d = isdigit(c) ? c - '0' : toupper(c) - 'A' + 10;
+            size_t bit = i * b;
+
+            x.d[bit / 64] |= d << bit % 64;
+
+            if (bit % 64 + b > 64)
+                x.d[bit / 64 + 1] |= d >> (64 - bit % 64);
         }
 
-        /* Multiple points are present */
-        default :
-            fprintf(stderr, "The codify is not correct.\n");
-            return 1;
+        return big_norm(x);
     }
 
-    switch (sign) {
-        /* No minus */
-        case -1:
-            break;
+    if (n <= BIG_DIGITS || !pw->levels) {
+        x.d = big_alloc(n / k + 1);
+        x.n = 0;
 
-        /* Minus is present */
-        case 0: {
-            for (unsigned i = 0; i < (sizeof(code) / sizeof(struct codify)); i++) {
-                if (from == code[i].id)
-                    if (!code[i].signf) {
-                        fprintf(stderr, "%s accepts only positive numbers.\n", code[i].name[0]);
-                        return 1;
-                    }
+        for (size_t i = 0, len = n % k ? n % k : k; i < n; i += len, len = k) {
+            uint64_t chunk = 0, mul = 1;
 
-                if (to == code[i].id)
-                    if (!code[i].signt) {
-                        fprintf(stderr, "%s accepts only positive numbers.\n", code[i].name[0]);
-                        return 1;
-                    }
+            for (size_t c = i; c < i + len; c++) {
+                chunk = chunk * base + (isdigit(str[c]) ? str[c] - '0' : toupper(str[c]) - 'A' + 10);
+                mul *= base;
             }
 
-            break;
+            for (size_t l = 0; l < x.n; l++) {
+                unsigned __int128 t = (unsigned __int128) x.d[l] * mul + chunk;
+
+                x.d[l] = t;
+                chunk = t >> 64;
+            }
+
+            if (chunk)
+                x.d[x.n++] = chunk;
         }
 
-        /* Multiple minus are present */
-        default:
-            fprintf(stderr, "The codify is not correct.\n");
-            return 1;
+        return x;
     }
 
-    /* Check whether the number is correct for the indicated base */
-    switch (from) {
-        case BIN:
-        case CO1:
-        case CO2:
-        case MES:
-
-            if (check_base(num, 2)) return 1;
-            break;
+    while (j + 1 < pw->levels && ((size_t) k << (j + 1)) < n)
+        j++;
 
-        case BCD:
-        case DEC:
-        case ROM:
+    size_t low = (size_t) k << j;
+    struct job high = {.src = str, .n = n - low, .pw = pw, .depth = depth - 1},
+            rest = {.src = str + n - low, .n = low, .pw = pw, .depth = depth - 1};
 
-            break;
+    big_fork(big_read_job, &high, &rest, depth);
 
-        default :
+    struct big t = big_product(high.x, pw->pow[j], depth);
 
-            if (check_base(num, from - SCRAP)) return 1;
-    }
+    x = big_sum(t, rest.x);
+    free(t.d);
+    free(high.x.d);
+    free(rest.x.d);
 
-    return 0;
+    return x;
 }
 
-/* OPTARG_DEFINE - Defines the type of conversion.
+/* BIG_READ_JOB - big_read() run by a thread.
 -----------------------------------------------------------------------------*/
-int optarg_define(const char *type) {
-    /* BCD */
-    for (unsigned i = 0; i < (sizeof code[BCD].name / sizeof(const char **)); i++)
-        if (!strcmp(type, code[BCD].name[i]))
-            return BCD;
+void *big_read_job(void *arg) {
+    struct job *j = arg;
 
-    /* Binary */
-    for (unsigned i = 0; i < (sizeof code[BIN].name / sizeof(const char **)); i++)
-        if (!strcmp(type, code[BIN].name[i]))
-            return BIN;
+    j->x = big_read(j->src, j->n, j->pw, j->depth);
 
-    /* Ones' Complement */
-    for (unsigned i = 0; i < (sizeof code[CO1].name / sizeof(const char **)); i++)
-        if (!strcmp(type, code[CO1].name[i]))
-            return CO1;
+    return NULL;
+}
 
-    /* Two's complement */
-    for (unsigned i = 0; i < (sizeof code[CO2].name / sizeof(const char **)); i++)
-        if (!strcmp(type, code[CO2].name[i]))
-            return CO2;
+/* BIG_RECIP - Returns floor(2^2bits / p), where p has 'bits' bits, with one
+ * step of Newton's iteration w' = 2w - p * w^2 / 2^2bits from the reciprocal
+ * of the upper half of p, which has half the correct bits. The few units of
+ * error left are then removed comparing p * w with 2^2bits.
+-----------------------------------------------------------------------------*/
+struct big big_recip(struct big p, size_t bits, int depth) {
+    const uint64_t one = 1;
+    struct big w;
 
-    /* Decimal */
-    for (unsigned i = 0; i < (sizeof code[DEC].name / sizeof(const char **)); i++)
-        if (!strcmp(type, code[DEC].name[i]))
-            return DEC;
+    if (bits <= 60) {
+        unsigned __int128 t = ((unsigned __int128) 1 << 2 * bits) / p.d[0];
 
-    /* Floating Point */
-    for (unsigned i = 0; i < (sizeof code[FLT].name / sizeof(const char **)); i++)
-        if (!strcmp(type, code[FLT].name[i]))
-            return FLT;
+        w.d = big_alloc(2);
+        w.d[0] = t;
+        w.d[1] = t >> 64;
+        w.n = 2;
 
-    /* Hexadecimal */
-    for (unsigned i = 0; i < (sizeof code[HEX].name / sizeof(const char **)); i++)
-        if (!strcmp(type, code[HEX].name[i]))
-            return SCRAP + 16;
+        return big_norm(w);
+    }
 
-    /* Signed Magnitude Representation */
-    for (unsigned i = 0; i < (sizeof code[MES].name / sizeof(const char **)); i++)
-        if (!strcmp(type, code[MES].name[i]))
-            return MES;
+    size_t h = bits / 2 + 2;
+    struct big top = big_shr(p, bits - h), wh = big_recip(top, h, depth),
+            sq = big_product(wh, wh, depth), t = big_product(p, sq, depth), s = big_shr(t, 2 * h);
 
-    /* Roman */
-    for (unsigned i = 0; i < (sizeof code[ROM].name / sizeof(const char **)); i++)
-        if (!strcmp(type, code[ROM].name[i]))
-            return ROM;
+    w = big_shl(wh, bits - h + 1);
+    big_sub(w.d, w.d, w.n, s.d, s.n);
+    w = big_norm(w);
 
-    /* Octal */
-    for (unsigned i = 0; i < (sizeof code[OCT].name / sizeof(const char **)); i++)
-        if (!strcmp(type, code[OCT].name[i]))
-            return SCRAP + 8;
+    free(top.d);
+    free(wh.d);
+    free(sq.d);
+    free(t.d);
+    free(s.d);
 
-    /* Base X */
-    if (!strncmp(type, "base", 4) || !strncmp(type, "BASE", 4)) {
-        int base = atoi(strrchr(type, 'e') + 1);
+    /* e = p * w must be the largest multiple of p not above 2^2bits */
+    struct big e = big_product(p, w, depth), lim = {big_alloc(2 * bits / 64 + 1), 2 * bits / 64 + 1};
 
-        if (base > 0 && base < 37)
-            return SCRAP + base;
+    lim.d[lim.n - 1] = (uint64_t) 1 << 2 * bits % 64;
 
-        return SCRAP;
+    while (big_cmp(e, lim) > 0) {
+        big_sub(e.d, e.d, e.n, p.d, p.n);
+        e = big_norm(e);
+        big_sub(w.d, w.d, w.n, &one, 1);
+        w = big_norm(w);
     }
 
-    return 0;
+    big_sub(lim.d, lim.d, lim.n, e.d, e.n);
+    lim = big_norm(lim);
+
+    while (big_cmp(lim, p) >= 0) {
+        big_sub(lim.d, lim.d, lim.n, p.d, p.n);
+        lim = big_norm(lim);
+        w.d[w.n] = big_add(w.d, w.d, w.n, &one, 1);
+        w.n++;
+        w = big_norm(w);
+    }
+
+    free(e.d);
+    free(lim.d);
+
+    return w;
 }
 
-/* PRINT_HELP - Show help message.
+/* BIG_SHL - Returns x * 2^bits.
 -----------------------------------------------------------------------------*/
-void print_help(const char *name) {
-    printf(
-            "%s\n"
-            "Radix and numerical codes converter\n\n"
-            "Usage: %s -f <CODIFY> -t <CODIFY> <NUMBER>\n\n"
+struct big big_shl(struct big x, size_t bits) {
+    size_t l = bits / 64, s = bits % 64;
+    struct big r = {big_alloc(x.n + l + 1), x.n + l + 1};
 
-            "Options:\n\n"
+    for (size_t i = 0; i < x.n; i++) {
+        r.d[i + l] |= x.d[i] << s;
 
-            " -f, --from            Source encoding\n"
-            " -t, --to              Destination encoding\n"
-            " -b  --bit             Number of bit/digit\n"
-            " -h, --help            Show this help message and exit\n"
-            " -v, --version         Show version and exit\n\n"
+        if (s)
+            r.d[i + l + 1] |= x.d[i] >> (64 - s);
+    }
 
-            "Codifies:\n\n"
+    return big_norm(r);
+}
 
-            " BASEX                 Generic Base\n"
-            " BCD                   Binary Coded Decimal\n"
-            " BIN                   Binary Base\n"
-            " CO1                   Ones' Complement\n"
-            " CO2                   Two's Complement\n"
-            " DEC                   Decimal Base\n"
-            " HEX                   Hexadecimal Base\n"
-            " MES                   Signed Magnitude Representation\n"
-            " OCT                   Octal Base\n"
-            " ROM                   Roman Numerals\n\n"
+/* BIG_SHR - Returns x / 2^bits, truncated.
+-----------------------------------------------------------------------------*/
+struct big big_shr(struct big x, size_t bits) {
+    size_t l = bits / 64, s = bits % 64;
+    struct big r = {NULL, x.n > l ? x.n - l : 0};
 
-            "Examples:\n"
-            " %s -f dec -t bin 18.05          It converts from base 10 to base 2\n"
-            " %s -f bin -t base15 1010011010  It converts from base 2 to base 15\n\n"
+    r.d = big_alloc(r.n);
 
-            "To enter a negative number type: -- <NUMBER>\n"
-            "For example, to enter the number -5 type: -- -5\n\n"
+    for (size_t i = 0; i < r.n; i++) {
+        r.d[i] = x.d[i + l] >> s;
 
-            "Report bugs to <norisgit@gmail.com>\n"
+        if (s && i + l + 1 < x.n)
+            r.d[i] |= x.d[i + l + 1] << (64 - s);
+    }
 
-            , VERSION, name, name, name);
+    return big_norm(r);
 }
 
+/* BIG_SPAWN - Starts f(arg) on a new thread, unless the threads of the big
+ * numbers running, with the one of the conversion, are already as many as the
+ * processors: a Karatsuba product starts two at each level, so 'depth' alone
+ * would start up to 3^depth. Returns 1 if the thread was started (it is then
+ * waited for with big_join()), 0 otherwise.
+-----------------------------------------------------------------------------*/
+int big_spawn(pthread_t *t, void *(*f)(void *), void *arg) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int n = __atomic_load_n(&big_threads, __ATOMIC_RELAXED);
 
-/*=============================================================================
- * TO DECIMAL CONVERSION FUNCTIONS
-=============================================================================*/
+    do
+        if (n + 1 >= cpus)
+            return 0;
+    while (!__atomic_compare_exchange_n(&big_threads, &n, n + 1, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
 
-/* BCD_TO_DEC - Converts a BCD-encoded number to a decimal number.
- * Returns -1 in the event of an error (if the BCD encoding is incorrect).
+    if (pthread_create(t, NULL, f, arg)) {
+        __atomic_sub_fetch(&big_threads, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    return 1;
+}
+
+/* BIG_SUB - Writes a - b in r (which may be a) and returns the borrow. 'a' has
+ * 'an' limbs, 'b' has 'bn' <= an limbs and r has room for an limbs.
 -----------------------------------------------------------------------------*/
-long double bcd_to_dec(const char *bcd) {
-    unsigned len = strlen(bcd);
-    long double dec = 0;
+uint64_t big_sub(uint64_t *r, const uint64_t *a, size_t an, const uint64_t *b, size_t bn) {
+    uint64_t borrow = 0;
 
-    /* If any numbers are missing in the encoding, it returns an error: remember
-     * that BCD encoding provides four bits to represent each decimal digit. */
-    if (len % 4 != 0)
-        return -1;
+    for (size_t i = 0; i < an; i++) {
+        uint64_t d = i < bn ? b[i] : 0, t = a[i] - d;
+        uint64_t out = a[i] < d;
 
-    /* The index i scans each bit of the number encoded in BCD. The index j defines
-     * the significance of the bits. Initially is set to 10^(len/4-1) which specifies
-     * whether the four bits being analysed correspond to units, tens, hundreds, etc.
-     * For example if the number encoded in BCD is 000100100011 (i.e. 123) then len=3
-     * and therefore j is initially set to j=10^(3-1)=100. In fact the most significant
-     * bit of 123 belongs to the hundreds. This value is then multiplied by the
-     * respective BCD encoding (via if). The cycle continues by dividing j by 10, so
-     * that the significance of the next four bits is correct. This is done until the
-     * bits are finished.
-     */
-    for (unsigned i = 0, j = powl(10, len / 4 - 1); i < len; i += 4, j /= 10) {
-        if (bcd[i] == '0' && bcd[i + 1] == '0' && bcd[i + 2] == '0' && bcd[i + 3] == '1')
-            dec += 1 * j;
-        else if (bcd[i] == '0' && bcd[i + 1] == '0' && bcd[i + 2] == '1' && bcd[i + 3] == '0')
-            dec += 2 * j;
-        else if (bcd[i] == '0' && bcd[i + 1] == '0' && bcd[i + 2] == '1' && bcd[i + 3] == '1')
-            dec += 3 * j;
-        else if (bcd[i] == '0' && bcd[i + 1] == '1' && bcd[i + 2] == '0' && bcd[i + 3] == '0')
-            dec += 4 * j;
-        else if (bcd[i] == '0' && bcd[i + 1] == '1' && bcd[i + 2] == '0' && bcd[i + 3] == '1')
-            dec += 5 * j;
-        else if (bcd[i] == '0' && bcd[i + 1] == '1' && bcd[i + 2] == '1' && bcd[i + 3] == '0')
-            dec += 6 * j;
-        else if (bcd[i] == '0' && bcd[i + 1] == '1' && bcd[i + 2] == '1' && bcd[i + 3] == '1')
-            dec += 7 * j;
-        else if (bcd[i] == '1' && bcd[i + 1] == '0' && bcd[i + 2] == '0' && bcd[i + 3] == '0')
-            dec += 8 * j;
-        else if (bcd[i] == '1' && bcd[i + 1] == '0' && bcd[i + 2] == '0' && bcd[i + 3] == '1')
-            dec += 9 * j;
-        else
-            return -1;
+        out |= t < borrow;
+        r[i] = t - borrow;
+        borrow = out;
     }
 
-    return dec;
+    return borrow;
 }
 
-/* C1_TO_DEC - Converts a binary ones' complement number to decimal.
- * It doesn't check if the passed number is actually binary: you must therefore
- * perform this check before calling the function.
+/* BIG_SUM - Returns a + b.
 -----------------------------------------------------------------------------*/
-long double co1_to_dec(const char *c1) {
-    /* If the number starts with 1 then is negative */
-    if (c1[0] == '1')
+struct big big_sum(struct big a, struct big b) {
+    if (a.n < b.n)
+        return big_sum(b, a);
 
-        /* I perform the ones' complement of the number then
-         * I convert from binary to decimal, and I put the
-         * minus sign because it is negative */
-        return rad_to_dec(c1_converter(c1), 2) * -1;
+    struct big r = {big_alloc(a.n), a.n + 1};
 
-    /* If the number starts with 0 then this is positive,
-     * and I simply convert it from binary to decimal */
-    return rad_to_dec(c1, 2);
+    r.d[a.n] = big_add(r.d, a.d, a.n, b.d, b.n);
+
+    return big_norm(r);
 }
 
-/* C2_TO_DEC - Converts a binary two's complement number to decimal.
-Needs a function that converts from binary to ones' complement. It does not
-check that the number passed is actually binary: you must therefore perform
-this check before calling the function.
+/* BIG_VALUE - Returns a big number as a long double, from its two most
+ * significant limbs.
 -----------------------------------------------------------------------------*/
-long double co2_to_dec(const char *c2) {
-    /* If the number starts with 1 then is negative */
-    if (c2[0] == '1')
-        return co1_to_dec(c2) - 1;
+long double big_value(struct big x) {
+    long double v = 0;
+    size_t i = x.n;
 
-    /* If the number starts with 0 then this is positive,
-     * and I simply convert it from binary to decimal */
-    return rad_to_dec(c2, 2);
+    for (; i > 0 && x.n - i < 2; i--)
+        v = v * 18446744073709551616.0L + x.d[i - 1];
+
+    return ldexpl(v, 64 * i);
 }
 
-/* MES_TO_DEC - Converts signed magnitude representation binary number into a
- * decimal number. It does not check that the number passed is binary: you must
- * therefore perform this action before calling the function.
+/* BIG_WRITE - Writes x < base^n with exactly n digits in base X, zeros first.
+ * The number is split by pow[j] = base^(k * 2^j), the largest power with less
+ * than n digits: the quotient and the remainder are written (by two threads
+ * if 'depth' > 0) as the first n - k * 2^j digits and the last k * 2^j ones.
+ * Short numbers are divided by base^k, which gives k digits at a time.
 -----------------------------------------------------------------------------*/
-long double mes_to_dec(const char *ms) {
-    char *m = malloc(strlen(ms));
+void big_write(struct big x, size_t n, char *str, const struct power *pw, int depth) {
+    unsigned base = pw->base, k = pw->k, j = 0;
 
-    if (!m) {
-        fprintf(stderr, "Memory allocation error.\n");
-        return -1;
+    if (!x.n) {
+        memset(str, '0', n);
+        return;
     }
 
-    strcpy(m, ms);
+    /* Powers of two: each digit is a group of bits */
+    if (!(base & (base - 1))) {
+        unsigned b = __builtin_ctz(base);
 
-    /* Set the first bit to 0 to perform
-     * a correct conversion to decimal */
-    m[0] = '0';
+        for (size_t i = 0; i < n; i++) {
+            size_t bit = i * b;
+            uint64_t d = bit / 64 < x.n ? x.d[bit / 64] >> bit % 64 : 0;
 
-    /* Convert the number to decimal */
-    long double dec = rad_to_dec(m, 2);
+            if (bit % 64 + b > 64 && bit / 64 + 1 < x.n)
+                d |= x.d[bit / 64 + 1] << (64 - bit % 64);
 
-    free(m);
+            d &= base - 1;
+            str[n - 1 - i] = d < 10 ? d + '0' : d - 10 + 'A';
+        }
 
-    /* If the first digit of the number in SMR is 1 then
-     * the number is negative (I multiply it by -1) */
-    if (ms[0] == '1')
-        return dec * -1;
+        return;
+    }
 
-    /* If the first digit is 0 then the number is
-     * positive, and I return it without changing it */
-    return dec;
-}
+    if (n <= BIG_DIGITS || !pw->levels) {
+        uint64_t *t = big_alloc(x.n), div = pw->pow[0].d[0];
+        size_t len = x.n;
 
-/* RAD_TO_DEC - Converts a number whatever base to decimal.
------------------------------------------------------------------------------*/
-long double rad_to_dec(const char *num, unsigned base) {
-    long double dec = 0;
-    unsigned sign = 0;
-    char num_int[100], num_dec[100];
+        memcpy(t, x.d, x.n * sizeof(uint64_t));
 
-    if (num[0] == '-') {
-        sign++;
-        num++;
-    }
+        for (size_t i = n; i > 0;) {
+            uint64_t rem = 0;
 
-    /* If there is a decimal part I separate it from the integer part */
-    if (strchr(num, '.') != NULL) {
-        strcpy(num_dec, strchr(num, '.') + 1);
-        unsigned len = strlen(num) - strlen(num_dec) - 1;
-        strncpy(num_int, num, len);
-        num_int[len] = '\0';
-    }
+            for (size_t l = len; l > 0; l--) {
+                unsigned __int128 cur = (unsigned __int128) rem << 64 | t[l - 1];
 
-    /* If there is no decimal part I save only the integer part */
-    else
-        strcpy(num_int, num);
+                t[l - 1] = cur / div;
+                rem = cur % div;
+            }
 
-    /* Convert the integer part to base X */
-    for (unsigned i = strlen(num_int), j = 0; i > 0; i--)
-        if (isdigit(num_int[i - 1]))
-            dec += ((num_int[i - 1] - '0') * powl(base, j++));
-        else
-            dec += ((toupper(num_int[i - 1]) - 'A' + 10) * powl(base, j++));
+            while (len && !t[len - 1])
+                len--;
 
-    /* Convert decimal part to decimal */
-    if (strchr(num, '.') != NULL)
-        for (int i = 0, j = 0; i < strlen(num_dec); i++)
-            if (isdigit(num_dec[i]))
-                dec += ((num_dec[i] - '0') * powl(base, --j));
-            else
-                dec += ((toupper(num_dec[i]) - 'A' + 10) * powl(base, --j));
+            for (unsigned c = 0; c < k && i > 0; c++, rem /= base)
+                str[--i] = rem % base < 10 ? rem % base + '0' : rem % base - 10 + 'A';
+        }
 
-    if (sign)
-        return -1 * dec;
+        free(t);
+        return;
+    }
 
-    return dec;
+    while (j + 1 < pw->levels && ((size_t) k << (j + 1)) < n)
+        j++;
+
+    size_t low = (size_t) k << j;
+    struct job high = {.str = str, .n = n - low, .pw = pw, .depth = depth - 1},
+            rest = {.str = str + n - low, .n = low, .pw = pw, .depth = depth - 1};
+
+    big_divmod(x, pw, j, &high.x, &rest.x, depth);
+    big_fork(big_write_job, &high, &rest, depth);
+
+    free(high.x.d);
+    free(rest.x.d);
 }
 
-/* ROM_TO_DEC - Converts from Roman numeration system to decimal.
+/* BIG_WRITE_JOB - big_write() run by a thread.
 -----------------------------------------------------------------------------*/
-long double rom_to_dec(const char *rom) {
-    /* Assign a priority to each symbol, increasing in value, from 1 to 7: if
-     * the character has a lower priority than the one to its left I sum it up,
-     * otherwise I subtract it. This is cycled for each character of the string,
-     * starting with the rightmost (last) character. */
+void *big_write_job(void *arg) {
+    struct job *j = arg;
 
-    enum {
-        no, pi, pv, px, pl, pc, pd, pm
-    };
-    long double dec = 0;
-    unsigned priority = 0;
+    big_write(j->x, j->n, j->str, j->pw, j->depth);
 
-    for (unsigned i = strlen(rom); i > 0; i--)
-        switch (toupper(rom[i - 1])) {
-            case 'I':
-                if (priority <= pi)
-                    dec += 1;
-                else
-                    dec -= 1;
+    return NULL;
+}
 
-                priority = pi;
-                break;
+/*=============================================================================
+ * I/O FUNCTIONS
+=============================================================================*/
 
-            case 'V':
-                if (priority <= pv)
-                    dec += 5;
-                else
-                    dec -= 5;
+/* IO_CLOSE - Writes the output block being filled, waits for all the transfers
+ * and stops the ring or the thread. The offset of a file written at explicit
+ * offsets is moved after the output, as write() would have done.
+ * Returns 1 if a transfer failed.
+-----------------------------------------------------------------------------*/
+int io_close(struct pipeline *p) {
+    if (p->used)
+        io_flush(p);
 
-                priority = pv;
-                break;
+    for (unsigned i = 0; i < QUEUE; i++)
+        while (p->rd[i].busy || p->wr[i].busy)
+            io_wait(p);
 
-            case 'X':
-                if (priority <= px)
-                    dec += 10;
-                else
-                    dec -= 10;
+    if (p->ring >= 0) {
+        munmap(p->sq_ptr, p->sq_size);
 
-                priority = px;
-                break;
+        if (p->cq_ptr != p->sq_ptr)
+            munmap(p->cq_ptr, p->cq_size);
 
-            case 'L':
-                if (priority <= pl)
-                    dec += 50;
-                else
-                    dec -= 50;
+        munmap(p->sqes, p->sqes_size);
+        close(p->ring);
 
-                priority = pl;
-                break;
+    } else {
+        pthread_mutex_lock(&p->lock);
+        p->stop = 1;
+        pthread_cond_broadcast(&p->cond);
+        pthread_mutex_unlock(&p->lock);
+        pthread_join(p->thread, NULL);
+    }
 
-            case 'C':
-                if (priority <= pc)
-                    dec += 100;
-                else
-                    dec -= 100;
+    if (p->out_off >= 0)
+        lseek(p->wr[0].fd, p->out_off, SEEK_SET);
 
-                priority = pc;
-                break;
+    free(p->rd[0].buf);
 
-            case 'D':
-                if (priority <= pd)
-                    dec += 500;
-                else
-                    dec -= 500;
+    return p->error;
+}
 
-                priority = pd;
-                break;
+/* IO_COMPLETE - Takes note that 'res' bytes of a transfer have been read or
+ * written (-errno on error). A transfer that was cut short is queued again for
+ * what is left, except a read of something other than a file, which gives
+ * what there is (0 bytes at the end of the input).
+-----------------------------------------------------------------------------*/
+void io_complete(struct pipeline *p, struct slot *s, int res) {
+    if (res == -EINTR || res == -EAGAIN) {
+        io_queue(p, s);
+        return;
+    }
 
-            case 'M':
-                if (priority <= pm)
-                    dec += 1000;
-                else
-                    dec -= 1000;
+    if (res < 0) {
+        fprintf(stderr, "%s: %s\n", s->write ? "write" : "read", strerror(-res));
+        p->error = 1;
+        res = 0;
+    }
 
-                priority = pm;
-                break;
+    s->done += res;
 
-            default :
-                fprintf(stderr, "The codify is not correct.\n");
-                return 0;
-        }
+    /* The rest of a block of a file, unless the file ended, or of a block
+     * written in sequence (a pipe can take part of it) */
+    if ((s->off >= 0 || s->write) && res && s->done < s->len) {
+        io_queue(p, s);
+        return;
+    }
 
-    return dec;
-}
+    if (s->write && !res && !p->error) {
+        fprintf(stderr, "write: %s\n", strerror(EIO));
+        p->error = 1;
+    }
 
+    s->busy = 0;
+    s->ready = !s->write;
 
-/*=============================================================================
-FROM DECIMAL CONVERSION FUNCTIONS
-=============================================================================*/
+    if (!s->write && (s->off < 0 || s->done < s->len) && !res)
+        p->eof = 1;
+}
 
-/* DEC_TO_BCD - Converts from decimal (positive integer) to BCD encoding.
+/* IO_FLUSH - Queues the writing of the output block being filled. Something
+ * other than a file is written one block at a time, in order.
 -----------------------------------------------------------------------------*/
-const char *dec_to_bcd(long double dec, char *bcd) {
-    char str[128];
+void io_flush(struct pipeline *p) {
+    struct slot *s = &p->wr[p->fill];
 
-    sprintf(str, "%.0Lf", dec);
+    TRACE(write_entry, p->used);
 
-    for (unsigned i = 0; i < strlen(str); i++)
-        switch (str[i]) {
-            case '0':
-                strcat(bcd, "0000");
-                break;
-            case '1':
-                strcat(bcd, "0001");
-                break;
-            case '2':
-                strcat(bcd, "0010");
-                break;
-            case '3':
-                strcat(bcd, "0011");
-                break;
-            case '4':
-                strcat(bcd, "0100");
-                break;
-            case '5':
-                strcat(bcd, "0101");
-                break;
-            case '6':
-                strcat(bcd, "0110");
-                break;
-            case '7':
-                strcat(bcd, "0111");
-                break;
-            case '8':
-                strcat(bcd, "1000");
-                break;
-            case '9':
-                strcat(bcd, "1001");
-                break;
-            default :
-                fprintf(stderr, "Unhandled exception.\n");
-                return NULL;
-        }
+    for (unsigned i = 0; i < QUEUE && p->out_off < 0; i++)
+        while (p->wr[i].busy)
+            io_wait(p);
+
+    s->len = p->used;
+    s->done = 0;
+    s->off = p->out_off;
 
-    return bcd;
+    if (p->out_off >= 0)
+        p->out_off += p->used;
+
+    io_queue(p, s);
+
+    TRACE(write_return, s->len, p->error);
+
+    p->fill = (p->fill + 1) % QUEUE;
+    p->used = 0;
 }
 
-/* DEC_TO_CO1 - Convert from decimal to ones' complement.
+/* IO_GET - Returns the next input block, with its length in 'len', or NULL
+ * at the end of the input. The block returned before can be read again: the
+ * following blocks are queued, so that they are read while this one is
+ * converted. Its bytes can be changed.
 -----------------------------------------------------------------------------*/
-const char *dec_to_co1(long double dec, char *co1) {
-    char *val = malloc(128);
+char *io_get(struct pipeline *p, size_t *len) {
+    struct slot *s;
 
-    if (!val) {
-        fprintf(stderr, "Memory allocation error.\n");
-        return NULL;
+    TRACE(read_entry, p->next);
+
+    if (p->cur >= 0) {
+        p->rd[p->cur].ready = 0;
+        p->next = (p->cur + 1) % QUEUE;
+        p->cur = -1;
     }
 
-    /* Convert to binary */
-    strcpy(co1, dec_to_rad(dec < 0 ? -1 * dec : dec, 2, val));
+    io_read(p);
+    s = &p->rd[p->next];
 
-    if (dec < 0) {
-        /* Perform the ones' complement */
-        strcpy(co1, c1_converter(co1));
+    while (s->busy)
+        io_wait(p);
 
-        /* Add '1' in front of the number */
-        unsigned len = strlen(co1);
-        for (unsigned i = 0; i < len; i++)
-            co1[len - i] = co1[len - i - 1];
+    TRACE(read_return, s->ready ? s->done : 0, p->error);
 
-        co1[0] = '1';
-        co1[len + 1] = '\0';
-    } else {
-        /* If the number is positive I add
-         * a zero to the binary number */
-        sprintf(val, "0%s", co1);
-        strcpy(co1, val);
-    }
+    if (!s->ready || !s->done)
+        return NULL;
+
+    p->cur = p->next;
+    *len = s->done;
 
-    free(val);
+    /* Something other than a file is read a block at a time */
+    io_read(p);
 
-    return co1;
+    return s->buf;
 }
 
-/* DEC_TO_CO2 - Convert from decimal to two's complement.
+/* IO_OPEN - Prepares the pipeline of a batch job, which reads 'in' and writes
+ * 'out': the transfers are made by an io_uring if the kernel has one,
+ * otherwise by a thread. Returns 1 on error.
 -----------------------------------------------------------------------------*/
-const char *dec_to_co2(long double dec, char *co2) {
-    char *val = malloc(128);
+int io_open(struct pipeline *p, int in, int out) {
+    struct stat st;
+    char *buf = malloc(2 * QUEUE * BLOCK);
 
-    if (!val) {
+    if (!buf) {
         fprintf(stderr, "Memory allocation error.\n");
-        return NULL;
+        return 1;
     }
 
-    /* Convert to ones' complement */
-    strcpy(co2, dec_to_co1(dec, val));
+    memset(p, 0, sizeof(*p));
+    p->cur = -1;
 
-    free(val);
+    for (unsigned i = 0; i < QUEUE; i++) {
+        p->rd[i] = (struct slot) {.buf = buf + i * BLOCK, .fd = in};
+        p->wr[i] = (struct slot) {.buf = buf + (QUEUE + i) * BLOCK, .fd = out, .write = 1};
+    }
 
-    if (dec > -1)
-        return co2;
+    /* Files are transferred at explicit offsets, anything else in sequence */
+    if (fstat(in, &st) || !S_ISREG(st.st_mode) || (p->in_off = lseek(in, 0, SEEK_CUR)) < 0)
+        p->in_off = p->in_size = -1;
+    else
+        p->in_size = st.st_size;
 
-    /* Add 1 */
-    return binary_sum1(co2);
-}
+    if (fstat(out, &st) || !S_ISREG(st.st_mode) || fcntl(out, F_GETFL) & O_APPEND ||
+        (p->out_off = lseek(out, 0, SEEK_CUR)) < 0)
+        p->out_off = -1;
 
-/* DEC_TO_FLT - Convert from decimal to floating point.
------------------------------------------------------------------------------*/
-const char *dec_to_flt(long double dec, char *flt) {
-    /* Save the sign of the number */
-    if (dec < 0) {
-        dec *= -1;
-        strcpy(flt, "1");
-    } else
-        strcpy(flt, "0");
+    if (!io_ring(p))
+        return 0;
 
-    char *val = malloc(128);
-    char *tmp = malloc(128);
+    /* No io_uring: a thread makes the transfers */
+    p->ring = -1;
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->cond, NULL);
 
-    if (!val || !tmp) {
-        fprintf(stderr, "Memory allocation error.\n");
-        return NULL;
+    if (pthread_create(&p->thread, NULL, io_thread, p)) {
+        fprintf(stderr, "Thread creation error.\n");
+        free(buf);
+        return 1;
     }
 
-    sprintf(tmp, "%Lf", dec);
+    return 0;
+}
 
-    /* Save the exponent in two's complement */
-    unsigned len = strlen(tmp) - strlen(strchr(tmp, '.'));
-    strcat(flt, dec_to_co2(len, val));
+/* IO_PUT - Copies len bytes at the end of the output, writing the blocks that
+ * get full.
+-----------------------------------------------------------------------------*/
+void io_put(struct pipeline *p, const char *str, size_t len) {
+    while (len) {
+        struct slot *s = &p->wr[p->fill];
+        size_t n = BLOCK - p->used < len ? BLOCK - p->used : len;
 
-    strcat(flt, dec_to_rad(atof(remove_symbols(tmp)), 2, val));
+        while (s->busy)
+            io_wait(p);
 
-    free(val);
-    free(tmp);
+        memcpy(s->buf + p->used, str, n);
+        p->used += n;
+        str += n;
+        len -= n;
 
-    //return flt;
-    return "TODO";
+        if (p->used == BLOCK)
+            io_flush(p);
+    }
 }
 
-/* DEC_TO_MES - Converts from signed magnitude representation to decimal.
+/* IO_QUEUE - Starts the transfer of what is left of a block: on the ring, or
+ * in the list of the thread.
 -----------------------------------------------------------------------------*/
-const char *dec_to_mes(long double dec, char *mes) {
-    char *val = malloc(128);
+void io_queue(struct pipeline *p, struct slot *s) {
+    s->busy = 1;
+
+    if (p->ring >= 0) {
+        unsigned tail = *p->sq_tail, i = tail & *p->sq_mask;
+        struct io_uring_sqe *e = &p->sqes[i];
+
+        memset(e, 0, sizeof(*e));
+        e->opcode = s->write ? IORING_OP_WRITE : IORING_OP_READ;
+        e->fd = s->fd;
+        e->addr = (uintptr_t) (s->buf + s->done);
+        e->len = s->len - s->done;
+        e->off = s->off < 0 ? (uint64_t) -1 : (uint64_t) (s->off + s->done);
+        e->user_data = (uintptr_t) s;
+
+        p->sq_array[i] = i;
+        __atomic_store_n(p->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+        while (syscall(__NR_io_uring_enter, p->ring, 1, 0, 0, NULL, 0) < 0)
+            if (errno != EINTR) {
+                io_complete(p, s, -errno);
+                break;
+            }
 
-    /* Convert the number to binary: if it is negative I add
-     * a 1 in front of the string, otherwise I add a zero */
-    sprintf(mes, "%s%s", dec < 0 ? "1" : "0", dec_to_rad(dec < 0 ? -1 * dec : dec, 2, val));
+        return;
+    }
 
-    free(val);
+    pthread_mutex_lock(&p->lock);
+    p->todo[p->todo_tail++ % (2 * QUEUE)] = s;
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->lock);
+}
 
-    return mes;
+/* IO_READ - Queues the reading of the following input blocks, in order, as
+ * long as there are free ones: a file can be read at any offset, while
+ * anything else is read a block at a time.
+-----------------------------------------------------------------------------*/
+void io_read(struct pipeline *p) {
+    for (struct slot *s = &p->rd[p->ahead]; !s->busy && !s->ready && !p->eof; s = &p->rd[p->ahead]) {
+        if (p->in_off < 0) {
+            for (unsigned i = 0; i < QUEUE; i++)
+                if (p->rd[i].busy)
+                    return;
+
+            s->len = BLOCK;
+            s->off = -1;
+
+        } else if (p->in_off < p->in_size) {
+            s->len = p->in_size - p->in_off < BLOCK ? p->in_size - p->in_off : BLOCK;
+            s->off = p->in_off;
+            p->in_off += s->len;
+
+        } else
+            return;
+
+        s->done = 0;
+        io_queue(p, s);
+        p->ahead = (p->ahead + 1) % QUEUE;
+    }
 }
 
-/* DEC_TO_RAD - Convert from decimal to base X.
+/* IO_RING - Sets up an io_uring for the pipeline, with room for all its
+ * blocks, by means of the system calls and the ring layout of the kernel.
+ * Rings older than Linux 5.6 cannot read at the current position, so they
+ * are not used. Returns 1 if there is no ring.
 -----------------------------------------------------------------------------*/
-const char *dec_to_rad(long double num, unsigned base, char *bin) {
-    char str_int[128], str_dec[128], tmp[128];
-    unsigned sign = 0;
+int io_ring(struct pipeline *p) {
+    struct io_uring_params prm;
 
-    /* If the number is negative I increase a counter to insert the sign
-     * later in the conversion string, and remove it from the number */
-    if (num < 0) {
-        sign++;
-        num *= -1;
+    memset(&prm, 0, sizeof(prm));
+
+    if ((p->ring = syscall(__NR_io_uring_setup, 2 * QUEUE, &prm)) < 0)
+        return 1;
+
+    if (!(prm.features & IORING_FEAT_RW_CUR_POS)) {
+        close(p->ring);
+        return 1;
     }
 
-    /* Put in "num_int" the integer part of the number
-     * and in "num_int" the decimal part of the number */
-    long double num_int;
-    long double num_dec = modfl(num, &num_int);
+    p->sq_size = prm.sq_off.array + prm.sq_entries * sizeof(unsigned);
+    p->cq_size = prm.cq_off.cqes + prm.cq_entries * sizeof(struct io_uring_cqe);
+    p->sqes_size = prm.sq_entries * sizeof(struct io_uring_sqe);
 
-    /* Convert the integer part from decimal to base X, dividing by base and
-     * saving the remainder: initially the number in base X will be reversed */
-    do {
-        unsigned v;
+    /* The two rings may share a mapping */
+    if (prm.features & IORING_FEAT_SINGLE_MMAP)
+        p->sq_size = p->cq_size = p->sq_size > p->cq_size ? p->sq_size : p->cq_size;
 
-        if ((v = fmodl(num_int, base)) < 10)
-            sprintf(tmp, "%u", v);
-        else
-            sprintf(tmp, "%c", v - 10 + 'A');
+    p->sq_ptr = mmap(NULL, p->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, p->ring,
+                     IORING_OFF_SQ_RING);
+    p->cq_ptr = prm.features & IORING_FEAT_SINGLE_MMAP ? p->sq_ptr :
+                mmap(NULL, p->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, p->ring,
+                     IORING_OFF_CQ_RING);
+    p->sqes = mmap(NULL, p->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, p->ring,
+                   IORING_OFF_SQES);
 
-        strcat(bin, tmp);
+    if (p->sq_ptr == MAP_FAILED || p->cq_ptr == MAP_FAILED || p->sqes == MAP_FAILED) {
+        close(p->ring);
+        return 1;
+    }
 
-    } while ((int) (num_int /= base));
+    p->sq_tail = (unsigned *) ((char *) p->sq_ptr + prm.sq_off.tail);
+    p->sq_mask = (unsigned *) ((char *) p->sq_ptr + prm.sq_off.ring_mask);
+    p->sq_array = (unsigned *) ((char *) p->sq_ptr + prm.sq_off.array);
+    p->cq_head = (unsigned *) ((char *) p->cq_ptr + prm.cq_off.head);
+    p->cq_tail = (unsigned *) ((char *) p->cq_ptr + prm.cq_off.tail);
+    p->cq_mask = (unsigned *) ((char *) p->cq_ptr + prm.cq_off.ring_mask);
+    p->cqes = (struct io_uring_cqe *) ((char *) p->cq_ptr + prm.cq_off.cqes);
 
-    /* If the number is negative I add a minus */
-    if (sign)
-        strcat(bin, "-");
+    return 0;
+}
 
-    /* Reverse the number */
-    unsigned len = strlen(bin);
-    for (unsigned i = 0; i < len / 2; i++) {
-        tmp[0] = bin[i];
-        bin[i] = bin[len - i - 1];
-        bin[len - i - 1] = tmp[0];
-    }
-
-    /* I convert the decimal part from decimal to base X, multiplying by base and
-     * saving the first digit of the result (< base), which will then be discarded
-     * at each cycle (e.g. for 1.27 is saved 1, and then it becomes 0.27) */
-    if (num_dec) {
-        
-        /* Insert decimal point */
-        strcat(bin, ".");
-
-        for (unsigned i = 0; i < PRECISION; i++) {
-            num_dec *= base;
-
-            /* The decimal part of the number is stored in 'num_dec': I convert it to
-             * an integer (the first time it will obviously be 0, later it may take
-             * values less than base) and save the result in "num_int" */
-            sprintf(str_int, "%Lf", num_dec);
-            unsigned value = atof(str_int);
-
-            /* The preceding instruction could be
-             * alternatively replaced by the following: */
-            //unsigned value = str_int[0] - '0';
-
-            /* Save the i-th part of the decimal part of the number in base X:
-            the first character of "str_int" will in fact always be < base */
-            len = strlen(bin);
-
-            if (value < 10) {
-                bin[len] = str_int[0];
-                bin[len + 1] = '\0';
-            } else {
-                char buff[3];
-                sprintf(buff, "%c", (unsigned) value - 10 + 'A');
-                strcat(bin, buff);
-            }
+/* IO_THREAD - Makes the transfers of a pipeline without io_uring, one at a
+ * time and in the order they were queued, with read() and write().
+-----------------------------------------------------------------------------*/
+void *io_thread(void *arg) {
+    struct pipeline *p = arg;
 
-            /* Save in 'num_dec' the decimal part of the decimal number */
-            sprintf(str_dec, "%Lf", num_dec - value);
-            num_dec = atof(str_dec);
-        }
+    pthread_mutex_lock(&p->lock);
+
+    for (;;) {
+        struct slot *s;
+        ssize_t r;
+
+        while (p->todo_head == p->todo_tail && !p->stop)
+            pthread_cond_wait(&p->cond, &p->lock);
+
+        if (p->todo_head == p->todo_tail)
+            break;
+
+        s = p->todo[p->todo_head++ % (2 * QUEUE)];
+        pthread_mutex_unlock(&p->lock);
+
+        if (s->write)
+            r = s->off < 0 ? write(s->fd, s->buf + s->done, s->len - s->done) :
+                pwrite(s->fd, s->buf + s->done, s->len - s->done, s->off + s->done);
+        else
+            r = s->off < 0 ? read(s->fd, s->buf + s->done, s->len - s->done) :
+                pread(s->fd, s->buf + s->done, s->len - s->done, s->off + s->done);
+
+        pthread_mutex_lock(&p->lock);
+        p->res[p->done_tail % (2 * QUEUE)] = r < 0 ? -errno : r;
+        p->done[p->done_tail++ % (2 * QUEUE)] = s;
+        pthread_cond_broadcast(&p->cond);
     }
 
-    return bin;
+    pthread_mutex_unlock(&p->lock);
+
+    return NULL;
 }
 
-/* DEC_TO_ROM - Converts from decimal to Roman numeration system.
+/* IO_WAIT - Waits until at least a transfer has ended, and takes note of all
+ * the ended ones.
 -----------------------------------------------------------------------------*/
-const char *dec_to_rom(long double dec) {
-    /* The equivalent of 0 is the latin word "nulla" */
-    if (dec == 0)
-        return "NULL";
+void io_wait(struct pipeline *p) {
+    if (p->ring >= 0) {
+        for (;;) {
+            unsigned head = *p->cq_head, tail = __atomic_load_n(p->cq_tail, __ATOMIC_ACQUIRE);
+
+            if (head != tail) {
+                for (; head != tail; head++) {
+                    struct io_uring_cqe c = p->cqes[head & *p->cq_mask];
+
+                    /* The entry can be used again by the kernel once read */
+                    __atomic_store_n(p->cq_head, head + 1, __ATOMIC_RELEASE);
+                    io_complete(p, (struct slot *) (uintptr_t) c.user_data, c.res);
+                }
 
-    char dec_str[128];
-    sprintf(dec_str, "%Lf", dec);
+                return;
+            }
 
-    for (unsigned i = strlen(dec_str); i > 0; i--) {
-        switch (dec_str[i]) {
-            case '0':
-                break;
-            case '1':
-                break;
+            if (syscall(__NR_io_uring_enter, p->ring, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+                errno != EINTR) {
+                perror("io_uring_enter");
+                exit(EXIT_FAILURE);
+            }
         }
     }
 
-    /* TODO */
+    pthread_mutex_lock(&p->lock);
+
+    while (p->done_head == p->done_tail)
+        pthread_cond_wait(&p->cond, &p->lock);
+
+    while (p->done_head != p->done_tail) {
+        struct slot *s = p->done[p->done_head % (2 * QUEUE)];
+        int res = p->res[p->done_head++ % (2 * QUEUE)];
 
-    return "TODO";
+        pthread_mutex_unlock(&p->lock);
+        io_complete(p, s, res);
+        pthread_mutex_lock(&p->lock);
+    }
+
+    pthread_mutex_unlock(&p->lock);
 }
 
 
 /*=============================================================================
- * AUXILIARY FUNCTIONS
+ * RING FUNCTIONS
 =============================================================================*/
 
-/* BINARY_SUM1 - Add 1 to a binary number.
+/* RING_BENCH - Sends 'calls' requests to the server of 'r', with the 'count'
+ * numbers 'num' in turn, and writes the minimum, median, 99th percentile and
+ * maximum time of their round trips. Returns 1 on error.
 -----------------------------------------------------------------------------*/
-const char *binary_sum1(char *bin) {
-    unsigned len = strlen(bin), count = 0;
-    unsigned *to_zero = malloc(len * sizeof(unsigned));
+int ring_bench(struct ring *r, char **num, size_t count, unsigned long calls) {
+    static char res[CELL];
+    uint64_t *ns = malloc(calls * sizeof(uint64_t));
+    size_t *len = malloc(count * sizeof(size_t)), rlen;
 
-    for (unsigned i = len; i > 0; i--) {
-        if (bin[i - 1] == '1')
-            to_zero[count++] = i - 1;
+    if (!ns || !len) {
+        fprintf(stderr, "Memory allocation error.\n");
+        free(ns);
+        free(len);
+        return 1;
+    }
 
-        else {
-            bin[i - 1] = '1';
+    for (size_t i = 0; i < count; i++)
+        len[i] = strlen(num[i]);
 
-            for (unsigned j = 0; j < count; j++)
-                bin[to_zero[j]] = '0';
+    for (unsigned long i = 0; i < calls; i++) {
+        struct timespec a, b;
 
-            return bin;
+        clock_gettime(CLOCK_MONOTONIC, &a);
+
+        if (ring_call(r, num[i % count], len[i % count], res, &rlen) < 0) {
+            fprintf(stderr, "The server has stopped.\n");
+            free(ns);
+            free(len);
+            return 1;
         }
-    }
 
-    bin[0] = '1';
+        clock_gettime(CLOCK_MONOTONIC, &b);
+        ns[i] = (b.tv_sec - a.tv_sec) * 1000000000ULL + b.tv_nsec - a.tv_nsec;
+    }
 
-    for (unsigned j = 1; j < count + 1; j++)
-        bin[j] = '0';
+    qsort(ns, calls, sizeof(uint64_t), ring_order);
+    printf("%lu calls: min %.2f us, median %.2f us, 99%% %.2f us, max %.2f us\n", calls,
+           ns[0] / 1e3, ns[calls / 2] / 1e3, ns[calls * 99 / 100] / 1e3, ns[calls - 1] / 1e3);
 
-    bin[count + 1] = '\0';
+    free(ns);
+    free(len);
 
-    return bin;
+    return 0;
 }
 
-/* BIT_NUMBER - It prints only the first n bits of a string.
+/* RING_CALL - Asks the server of 'r' to convert the number 'num' (its 'len'
+ * characters) and copies the results in 'res', which has room for CELL
+ * characters, setting 'rlen' to their length. This is all a client needs once
+ * the ring is open (see ring_open()), from any number of threads. Returns the
+ * error code of the conversion (see enum errors), or -1 if the server has
+ * stopped (or on a SIGINT, with the handler of ring_stop()).
 -----------------------------------------------------------------------------*/
-const char *bit_number(char *str, unsigned bit, unsigned phase) {
-    unsigned len = strlen(str);
+int ring_call(struct ring *r, const char *num, size_t len, char *res, size_t *rlen) {
+    struct cell *c;
+    uint32_t t, now;
+    int error;
+
+    /* Checked before taking a ticket, which the server would wait for */
+    if (len >= CELL) {
+        *rlen = 0;
+        fail(E_RING, CELL);
+        return E_RING;
+    }
 
-    if (bit == 0)
-        return str;
+    /* The ticket is taken only when its cell is free: until then the cell of
+     * the next ticket is watched, as 'tail' may move meanwhile */
+    for (unsigned i = 0;; i++) {
+        t = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+        c = &r->cell[t % RING];
+        now = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE);
 
-    if (len > bit && phase) {
-        fprintf(stderr, "Too few bit. It requires almost %u bit.\n", len);
-        return NULL;
-    }
+        if (now == t) {
+            if (__atomic_compare_exchange_n(&r->tail, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+                break;
 
-    char *str_cpy = malloc(len);
-    strcpy(str_cpy, str);
-    strcpy(str, "");
+            continue;
+        }
 
-    for (unsigned i = 0; i < (bit - len); i++)
-        strcat(str, "0");
+        if (halt || !__atomic_load_n(&r->server, __ATOMIC_RELAXED))
+            return -1;
 
-    strcat(str, str_cpy);
+        if (i >= SPIN)
+            ring_sleep(r, c, now);
+    }
 
-    free(str_cpy);
+    /* The client before the ticket, so that a reclaimer never pairs them
+     * wrong (see ring_reclaim()) */
+    __atomic_store_n(&c->client, getpid(), __ATOMIC_RELAXED);
+    __atomic_store_n(&c->ticket, t, __ATOMIC_RELEASE);
+    memcpy(c->text, num, len);
+    c->len = len;
+    __atomic_store_n(&c->seq, t + 1, __ATOMIC_SEQ_CST);
+    ring_wake(c);
+
+    /* Results no one collects: the cell is left to be reclaimed */
+    if (ring_wait(r, c, t + 2)) {
+        __atomic_store_n(&c->client, 0, __ATOMIC_RELEASE);
+        return -1;
+    }
 
-    return str;
+    memcpy(res, c->text, *rlen = c->len);
+    error = c->error;
+    __atomic_store_n(&c->seq, t + RING, __ATOMIC_SEQ_CST);
+    ring_wake(c);
+
+    return error;
 }
 
-/* C1_CONVERTER - Performs the ones' complement of the binary number entered.
- * Doesn't check if the number is binary: you must therefore perform this
- * check before calling the function.
+/* RING_OPEN - Maps the ring of the server 'name', a name of shm_open(). With
+ * 'create' the ring is made for a new server, otherwise the one of a running
+ * server is opened. Returns NULL on error.
 -----------------------------------------------------------------------------*/
-char *c1_converter(const char *bin) {
-    unsigned len = strlen(bin);
-    char *c1 = malloc(len + 1);
+struct ring *ring_open(const char *name, int create) {
+    int fd = shm_open(name, create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR, 0600);
+    struct ring *r = MAP_FAILED;
+    struct stat st;
+
+    if (fd < 0) {
+        if (errno == EEXIST)
+            fprintf(stderr, "%s: the ring exists already; if its server has ended, remove it from /dev/shm.\n", name);
+        else
+            perror(name);
 
-    if (!c1) {
-        fprintf(stderr, "Memory allocation error.\n");
         return NULL;
     }
 
-    for (unsigned i = 0; i < len; i++)
-        c1[i] = bin[i] == '0' ? '1' : '0';
+    if (create ? !ftruncate(fd, sizeof(struct ring)) : !fstat(fd, &st) && st.st_size >= (off_t) sizeof(struct ring))
+        r = mmap(NULL, sizeof(struct ring), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
 
-    // TODO FREE
+    close(fd);
 
-    return c1;
+    if (r == MAP_FAILED) {
+        fprintf(stderr, "%s: the ring cannot be mapped.\n", name);
+
+        if (create)
+            shm_unlink(name);
+
+        return NULL;
+    }
+
+    if (!create && !__atomic_load_n(&r->server, __ATOMIC_ACQUIRE)) {
+        fprintf(stderr, "%s: the server has stopped.\n", name);
+        munmap(r, sizeof(struct ring));
+        return NULL;
+    }
+
+    return r;
 }
 
-/* CHECK_BASE - Returns 0 if the passed string contains only the digits allowed
- * for that particular base (e.g. 0,1,2,3,4,5,6,7 in octal base or 0 and 1 in
- * binary base). Returns 1 if invalid values are contained.
+/* RING_ORDER - Compares two times for qsort().
 -----------------------------------------------------------------------------*/
-int check_base(const char *x, unsigned base) {
-    unsigned count = 0, point = 0;
+int ring_order(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
 
-    /* The minus in the first position is a valid character */
-    if (x[0] == '-')
-        count++;
+    return (x > y) - (x < y);
+}
 
-    /* Increase count at each valid character */
-    for (unsigned i = 0; i < strlen(x); i++) {
-        /* The character is valid if it is correct for that base */
-        if (x[i] - '0' < base)
-            count++;
+/* RING_RECLAIM - Frees the cell 'c', whose 'seq' was 'now', if the client
+ * holding it (see struct ring) has ended or given it up: it has taken the cell
+ * without sending its number ('seq' is its ticket) or has not collected the
+ * results ('seq' is its ticket + 2).
+-----------------------------------------------------------------------------*/
+void ring_reclaim(struct cell *c, uint32_t now) {
+    uint32_t t = __atomic_load_n(&c->ticket, __ATOMIC_ACQUIRE);
+    pid_t pid = __atomic_load_n(&c->client, __ATOMIC_ACQUIRE);
 
-        /* The letter must be correct for that particular base */
-        else if (toupper(x[i]) >= 'A' && toupper(x[i]) <= base + 'A' - 11)
-            count++;
+    if (now != t && now != t + 2)
+        return;
 
-        /* Count the points present (there may be 0 or 1) */
-        else if (x[i] == '.') {
-            count++;
-            point++;
-        }
+    if (pid && (!kill(pid, 0) || errno != ESRCH))
+        return;
+
+    if (__atomic_compare_exchange_n(&c->seq, &now, t + RING, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+        ring_wake(c);
+}
+
+/* RING_SLEEP - Sleeps until the 'seq' of the cell 'c' of 'r' is no longer
+ * 'now', or for a second: then the server is looked for, as it may have ended
+ * without stopping, and the cell is reclaimed if its client has ended (see
+ * ring_reclaim()).
+-----------------------------------------------------------------------------*/
+void ring_sleep(struct ring *r, struct cell *c, uint32_t now) {
+    const struct timespec second = {1, 0};
+
+    /* The sleeper is counted before the futex checks that 'seq' is still the
+     * same, so the change cannot be missed (see ring_wake()) */
+    __atomic_fetch_add(&c->waiters, 1, __ATOMIC_SEQ_CST);
+
+    if (syscall(SYS_futex, &c->seq, FUTEX_WAIT, now, &second, NULL, 0) && errno == ETIMEDOUT) {
+        if (kill(r->server, 0) && errno == ESRCH)
+            __atomic_store_n(&r->server, 0, __ATOMIC_RELAXED);
+
+        else
+            ring_reclaim(c, now);
     }
 
-    /* The string is correct if count is equal to the length of
-     * the string and if the number of decimal points is 0 or 1 */
-    if (count == strlen(x) && point < 2)
-        return 0;
+    __atomic_fetch_sub(&c->waiters, 1, __ATOMIC_SEQ_CST);
+}
 
-    fprintf(stderr, "Inserted number is not in base %u.\n", base);
-    return 1;
+/* RING_STOP - Handler of the signals that stop a server, or a follow job.
+-----------------------------------------------------------------------------*/
+void ring_stop(int sig) {
+    (void) sig;
+    halt = 1;
 }
 
-/* REMOVE_SYMBOLS - Removes everything other than a number.
+/* RING_WAIT - Waits until the 'seq' of the cell 'c' of 'r' is 'seq': it is
+ * polled SPIN times, then the thread sleeps until it changes (see
+ * ring_sleep()). Returns 1 if the server stops meanwhile, 2 if 'seq' is passed
+ * (the cell was reclaimed from a client that never sent its number), 0
+ * otherwise.
 -----------------------------------------------------------------------------*/
-const char *remove_symbols(char *str) {
-    for (unsigned i = 0, j = 0; i < strlen(str) + 1; i++)
-        if (isdigit(str[i]) || str[i] == '\0')
-            str[j++] = str[i];
-    return str;
-}
\ No newline at end of file
+int ring_wait(struct ring *r, struct cell *c, uint32_t seq) {
+    for (unsigned i = 0;; i++) {
+        uint32_t now = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE);
+
+        if (now == seq)
+            return 0;
+
+        if ((int32_t) (now - seq) > 0)
+            return 2;
+
+        if (halt || !__atomic_load_n(&r->server, __ATOMIC_RELAXED))
+            return 1;
+
+        if (i >= SPIN)
+            ring_sleep(r, c, now);
+    }
+}
+
+/* RING_WAKE - Wakes those sleeping on the cell 'c', after its 'seq' changed.
+-----------------------------------------------------------------------------*/
+void ring_wake(struct cell *c) {
+    if (__atomic_load_n(&c->waiters, __ATOMIC_SEQ_CST))
+        syscall(SYS_futex, &c->seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}